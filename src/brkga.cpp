@@ -1,30 +1,292 @@
 #include "brkga.hpp"
+#include "fitness_cache.hpp"
+#include "crossover.hpp"
+#include "migration.hpp"
+#include "ranked_pool.hpp"
+#include "mutant_factory.hpp"
 
-/**** BRKGA-Pr
-@param P: Population size
-@param E: Elite set size
-@param R: Number of mutant individuals (new solutions)
-@param PROB: Probability of inheriting the key from the elite parent
-@param INIT: Constructive method for the initial population
-*/
-void brkga(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT) {
-    std::vector<SolutionRK> population(P), next_population(P);
+// With screening, every SCREEN_AUDIT generations all offspring are evaluated to measure the estimate
+constexpr usize SCREEN_AUDIT = 32;
+
+// Evaluations and improvements of one worker (summed for the report)
+struct alignas(64) WorkerStats {
+    std::chrono::nanoseconds evaluation_time{0};
+    std::chrono::nanoseconds improve_time{0};
+    unsigned long n_evaluations = 0;
+    unsigned long n_improved = 0;
+    unsigned long improvement = 0;
+    unsigned long n_capped = 0; // Improvements stopped by the time cap before a local optimum
+};
+
+// Run of one population
+struct PopulationResult {
+    unsigned long best = 0; // Objective value of the best individual
+    usize generations = 0;
+    std::chrono::nanoseconds time{0};
+    unsigned long immigrants = 0; // Individuals received from other islands
+};
+
+// Kendall rank correlation (tau-a) between pairs <estimate, exact>
+realT kendallTau(const std::vector<std::pair<unsigned long, unsigned long>>& est_exact) {
+    const usize n = est_exact.size();
+    if (n < 2) return 1;
+    long balance = 0; // Concordant - discordant pairs
+    for (usize a = 0; a < n; ++a) {
+        for (usize b = a + 1; b < n; ++b) {
+            const long d_est = (est_exact[a].first > est_exact[b].first) - (est_exact[a].first < est_exact[b].first);
+            const long d_exact = (est_exact[a].second > est_exact[b].second) - (est_exact[a].second < est_exact[b].second);
+            balance += d_est * d_exact;
+        }
+    }
+    return static_cast<realT>(balance) / (static_cast<realT>(n) * (n - 1) / 2);
+}
+
+// Invariants of the population (sorted by the objective): every member has its own slot of the arena,
+// its labels are a permutation and the decoding of its keys (the delta decoder takes the labels
+// of the parents as their keys sorted; a lean arena has only keys, decoded here), the stored values match a new evaluation (only the elite set when
+// offspring are screened) and the elite set is sorted and not worse than the rest
+template <Objective OBJ, typename DECODER>
+void checkInvariants(CSR& csr, const PopulationArena& arena, const std::vector<Ranked>& population, const usize E, const bool screening, const usize generation) {
+    const auto fail = [generation](const std::string& message) {
+        std::cerr << "\n Invariant violated in generation " << generation << ": " << message << std::endl;
+        exit(EXIT_FAILURE);
+    };
+
+    std::vector<char> taken(arena.slots(), false);
+    for (usize i = 0; i < population.size(); ++i) {
+        const usize slot = population[i].slot;
+        if (taken[slot])
+            fail("slot of individual " + std::to_string(i) + " is shared");
+        taken[slot] = true;
+
+        if (arena.hasLabels()) {
+            const usize* labels = arena.labels(slot);
+            csr.labels.assign(labels, labels + csr.m);
+            if (!isPermutation(csr.labels, csr.m))
+                fail("individual " + std::to_string(i) + " is not a permutation");
+
+            csr.random_keys.assign(arena.keys(slot), arena.keys(slot) + csr.m);
+            DECODER::decode(csr);
+            if (!std::equal(csr.labels.begin(), csr.labels.end(), labels))
+                fail("labels of individual " + std::to_string(i) + " are not the decoding of its keys");
+        } else {
+            // Lean arena: the decoding of the keys
+            csr.random_keys.assign(arena.keys(slot), arena.keys(slot) + csr.m);
+            DECODER::decode(csr);
+            if (!isPermutation(csr.labels, csr.m))
+                fail("decoding of individual " + std::to_string(i) + " is not a permutation");
+        }
+
+        if (i < E || !screening) {
+            const unsigned long value = csr.evaluateObjective<OBJ>();
+            if (value != population[i].profile)
+                fail("stored value of individual " + std::to_string(i) + " is " + std::to_string(population[i].profile) + ", evaluated " + std::to_string(value));
+        }
+    }
+
+    if (!std::is_sorted(population.begin(), population.begin() + E))
+        fail("elite set is not sorted");
+    if (E < population.size() && population[E].profile < population[E - 1].profile)
+        fail("elite set is worse than the rest of the population");
+}
+
+// Builds a random solution of csr as a mutant (returns its objective value)
+template <Objective OBJ, typename DECODER>
+struct MutantBuilder {
+    usize INIT; // Constructive method (see initPopulation)
+
+    unsigned long operator()(CSR& ws) const {
+        if (INIT == 0) {
+            ws.constructiveNSloanMGPS(realZeroOneInclusive());
+        } else {
+            ws.msWConstrutiveSM({});
+        }
+        DECODER::encode(ws);
+        return ws.evaluateObjective<OBJ>();
+    }
+};
+
+// Background builders of the mutants (null without opt.producers)
+// The queue keeps between R and 4R mutants built ahead of the consumption
+template <Objective OBJ, typename DECODER>
+std::unique_ptr<MutantFactory<MutantBuilder<OBJ, DECODER>>> mutantFactory(const CSR& csr, const usize R, const usize INIT, const BRKGAOptions& opt) {
+    if (opt.producers == 0 || R == 0)
+        return nullptr;
+    return std::make_unique<MutantFactory<MutantBuilder<OBJ, DECODER>>>(csr, opt.producers, R, 4 * R, getRNG()(), MutantBuilder<OBJ, DECODER>{INIT});
+}
+
+// Report the mutant factory
+template <typename BUILD>
+void reportFactory(MutantFactory<BUILD>& factory) {
+    std::cout << "\nMutant factory: " << factory.producers() << " producers, " << factory.built << " mutants built, "
+              << factory.n_waits << " pops waited for a mutant ("
+              << std::chrono::duration<realT, std::milli>(factory.wait_time).count() << " ms), queue depth "
+              << factory.currentDepth() << '\n';
+}
+
+// Exact evaluation of ws.labels (timed for the report of the cache)
+template <Objective OBJ>
+unsigned long evaluateTimed(CSR& ws, WorkerStats& st) {
+    const auto t0 = std::chrono::steady_clock::now();
+    const unsigned long value = ws.evaluateObjective<OBJ>();
+    st.evaluation_time += std::chrono::steady_clock::now() - t0;
+    ++st.n_evaluations;
+    return value;
+}
+
+// Improve ws.labels and encode them back into ws.random_keys (returns the objective)
+template <Objective OBJ, typename DECODER>
+unsigned long improveOffspring(CSR& ws, WorkerStats& st, const std::chrono::nanoseconds cap) {
+    const auto t0 = std::chrono::steady_clock::now();
+    bool capped = false;
+    st.improvement += ws.improveProfile(cap, &capped);
+    st.n_capped += capped;
+    unsigned long value = ws.profile + (OBJ == Objective::Envelope ? ws.m : 0);
+    if (!encoderSorted(ws)) {
+        // Equal keys: back to the decoding of the keys
+        DECODER::decode(ws);
+        value = ws.evaluateObjective<OBJ>();
+    }
+    st.improve_time += std::chrono::steady_clock::now() - t0;
+    ++st.n_improved;
+    return value;
+}
+
+// Report the improvement and the fitness cache of the workers
+void reportStats(const std::vector<WorkerStats>& stats, const FitnessCache& cache, const bool improving) {
+    WorkerStats total;
+    for (const WorkerStats& st : stats) {
+        total.evaluation_time += st.evaluation_time;
+        total.improve_time += st.improve_time;
+        total.n_evaluations += st.n_evaluations;
+        total.n_improved += st.n_improved;
+        total.improvement += st.improvement;
+        total.n_capped += st.n_capped;
+    }
+    if (improving) {
+        std::cout << "\nImprovement: " << total.n_improved << " offspring improved, profile reduced by "
+                  << (total.n_improved == 0 ? 0 : static_cast<realT>(total.improvement) / total.n_improved) << " on average in "
+                  << (total.n_improved == 0 ? 0 : std::chrono::duration<realT, std::milli>(total.improve_time).count() / total.n_improved) << " ms, "
+                  << total.n_capped << " stopped by the time cap\n";
+    }
+    if (cache.enabled()) {
+        const unsigned long hits = cache.hits, lookups = hits + cache.misses;
+        const realT mean_ms = total.n_evaluations == 0 ? 0 : std::chrono::duration<realT, std::milli>(total.evaluation_time).count() / total.n_evaluations;
+        std::cout << "\nFitness cache: " << hits << " hits in " << lookups << " lookups ("
+                  << (lookups == 0 ? 0 : 100.0 * hits / lookups) << "%), "
+                  << hits * mean_ms << " ms of evaluation saved (" << mean_ms << " ms per evaluation), "
+                  << cache.dropped << " insertions dropped, " << cache.bytes() / 1024 << " KiB\n";
+    }
+}
+
+// Report the busy time of the workers of the run (time)
+void reportWorkers(const std::vector<TaskStats>& work, const std::chrono::nanoseconds time) {
+    std::cout << '\n';
+    for (usize w = 0; w < work.size(); ++w) {
+        const realT busy_ms = std::chrono::duration<realT, std::milli>(work[w].busy).count();
+        std::cout << "Worker " << w << ": busy " << busy_ms << " ms (" << 100 * busy_ms / std::max<realT>(std::chrono::duration<realT, std::milli>(time).count(), 1e-9)
+                  << "% of the run), " << work[w].tasks << " tasks in " << work[w].batches << " batches, " << work[w].steals << " steals\n";
+    }
+}
+
+// The best individual into csr (labels, inverse, profile and best_profile)
+// best_profile is the profile of the returned labels: labelings evaluated inside the heuristics that did not
+// reach the population (the level and Sloan decoders cannot encode them) are not reported
+template <typename DECODER>
+void finishPopulation(CSR& csr, const PopulationArena& arena, const Ranked& best) {
+    arena.load(best.slot, csr);
+    if (!arena.hasLabels())
+        DECODER::decode(csr);
+    csr.evaluateProfile();
+    csr.best_profile = csr.profile;
+}
+
+// Evolve one population of BRKGA-Pr on csr (its best individual is left in csr)
+// With a migration, the population is the island `island` and exchanges migrants with the others
+template <Objective OBJ, typename DECODER>
+PopulationResult brkgaPopulation(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt,
+                                 const unsigned long lower_bound, Migration* migration, const usize island) {
     csr.random_keys.resize(csr.m);
     csr.tmp_rk.resize(csr.m);
     csr.indexed_rk.resize(csr.m);
-    std::uniform_int_distribution<usize> distributionElite(0, E - 1);
-    std::uniform_int_distribution<usize> distributionPop(0, P - 1);
+    csr.changed.resize(csr.m);
+    const BernoulliMask inherit(PROB); // Genes inherited from the elite parent
+    unsigned long best_known = std::numeric_limits<unsigned long>::max();
+    realT gap = 1;
+    PopulationResult result;
+    // Migrants replace the worst individuals, never the elite set
+    const usize n_migrants = std::min({opt.migrants, E, P - E});
 
-    /// Initial population
-    initPopulation(csr, INIT, population, P);
+    /// Population arena (allocated once): the P individuals and the P - E slots of the next generation
+    // Lean: keys only, the labels of an individual are decoded when needed (never by crossover)
+    PopulationArena arena(2 * P - E, csr.m, !opt.lean);
+    std::vector<Ranked> population(P), next_population(P);
+    std::vector<char> in_population(arena.slots());
 
-    /// Alocating and next_population (Elite ones are moved)
-    for (usize i = E; i < P; ++i) {
-        next_population[i].random_keys.resize(csr.m);
-        next_population[i].labels.resize(csr.m);
-        std::iota(next_population[i].labels.begin(), next_population[i].labels.end(), 0);
+    /// Initial population
+    initPopulation<OBJ, DECODER>(csr, INIT, arena, population, P);
+    if (opt.verbose) {
+        std::cout << "Population memory: " << static_cast<realT>(arena.bytes()) / (1 << 20) << " MiB ("
+                  << arena.slots() << (arena.hasLabels() ? " slots of keys and labels)\n" : " slots of keys)\n");
     }
 
+    /// Offspring screening
+    // The profile of offspring is estimated on a fixed stratified sample of rows and only
+    // offspring that may enter the elite set are evaluated exactly
+    // The sample estimates the profile (and the envelope), not the other objectives
+    constexpr bool PROFILE_BASED = OBJ == Objective::Profile || OBJ == Objective::Envelope;
+    /// Lamarckian improvement (improveProfile on the decoded offspring, written back into its keys)
+    // Only for the profile-based objectives and decoders whose labels are the keys sorted
+    // The improvement evaluates the offspring exactly, so it replaces screening and the cache
+    constexpr bool IMPROVABLE = PROFILE_BASED && DECODER::SORTED;
+    const bool improving = IMPROVABLE && opt.improve > 0;
+    const auto improve_cap = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<realT, std::milli>(opt.improve));
+
+    const bool screening = PROFILE_BASED && opt.screen > 0 && !improving;
+    if (screening)
+        csr.sampleRows(static_cast<usize>(std::ceil(opt.screen * csr.m)));
+    std::vector<usize> offspring(P - E - R);
+    std::vector<std::pair<unsigned long, unsigned long>> audit; // <estimate, exact>
+    unsigned long n_offspring = 0, n_exact = 0, n_missed = 0;
+    usize n_audits = 0, generation = 0;
+    realT sum_tau = 0;
+
+    /// Fitness cache (offspring decoded into an already evaluated labeling are not evaluated)
+    FitnessCache cache(improving ? 0 : opt.cache);
+    std::vector<Fingerprint> fingerprints(P);
+    std::vector<char> cached(P, false);
+
+    /// Workers (mutants and offspring of a generation are built in parallel, see parallelTasks)
+    // Worker 0 (the calling thread) works on csr and the others on copies of it (their workspaces: own
+    // buffers on the shared graph)
+    const usize n_workers = numWorkers(P - E);
+    std::vector<CSR> workspaces(n_workers - 1, csr);
+    std::vector<WorkerStats> stats(n_workers);
+    std::vector<TaskStats> work(n_workers); // Scheduling of the tasks (busy time of each worker)
+    if (opt.verbose)
+        std::cout << "Workers: " << n_workers << " (" << P - E << " mutants and offspring per generation)\n";
+    const auto workspace = [&csr, &workspaces](const usize worker) -> CSR& {
+        return worker == 0 ? csr : workspaces[worker - 1];
+    };
+    const MutantBuilder<OBJ, DECODER> buildMutant{INIT};
+    // Mutants built ahead by background producers (the generation pops them)
+    const auto factory = mutantFactory<OBJ, DECODER>(csr, R, INIT, opt);
+
+    const auto evaluate = evaluateTimed<OBJ>;
+    const auto improve = [&improve_cap](CSR& ws, WorkerStats& st) {
+        return improveOffspring<OBJ, DECODER>(ws, st, improve_cap);
+    };
+
+    // Labels of the individual in slot into ws.labels (decoded from its keys if the arena is lean)
+    const auto labelsOf = [&arena](const usize slot, CSR& ws) {
+        if (arena.hasLabels()) {
+            std::copy_n(arena.labels(slot), ws.m, ws.labels.begin());
+        } else {
+            std::copy_n(arena.keys(slot), ws.m, ws.random_keys.begin());
+            DECODER::decode(ws);
+        }
+    };
+
     const auto start = std::chrono::steady_clock::now();
     /// Main loop
     /// Time limit enforced at the bottom
@@ -32,118 +294,504 @@ void brkga(CSR& csr, const usize P, const usize E, const usize R, const realT PR
         /// Sort individuals based on OF
         std::sort(population.begin(), population.end());
 
-        /// MUTANTS (Random solutions)
-        for (usize i = E; i < (E + R); ++i) {
-            if (INIT == 0) {
-                csr.constructiveNSloanMGPS(realZeroOneInclusive());
-            } else {
-                csr.msWConstrutiveSM({});
+        /// MIGRATION (islands, every opt.migration generations)
+        // The best individuals are sent to the next island (ring) or to a random one, and the latest
+        // migrants received replace the worst individuals (see Migration, no island waits)
+        if (migration != nullptr && n_migrants > 0 && generation > 0 && generation % opt.migration == 0) {
+            std::vector<SolutionRK> emigrants(n_migrants);
+            for (usize j = 0; j < n_migrants; ++j)
+                emigrants[j] = arena.solution(population[j].slot, population[j].profile);
+            migration->send(island, std::move(emigrants));
+
+            std::vector<SolutionRK> migrants = migration->receive(island);
+            const usize n_received = std::min<usize>(migrants.size(), n_migrants);
+            for (usize j = 0; j < n_received; ++j) {
+                Ranked& worst = population[P - 1 - j];
+                worst.profile = migrants[j].profile;
+                if (migrants[j].labels.empty() && arena.hasLabels()) {
+                    // Keys only (from another process or a lean island)
+                    std::swap(migrants[j].random_keys, csr.random_keys);
+                    DECODER::decode(csr);
+                    arena.store(worst.slot, csr);
+                } else {
+                    arena.store(worst.slot, migrants[j]);
+                }
             }
+            result.immigrants += n_received;
+            if (n_received > 0)
+                std::sort(population.begin(), population.end());
+        }
+        if (opt.check)
+            checkInvariants<OBJ, DECODER>(csr, arena, population, E, screening, generation);
 
-            encoder(csr);
-            csr.evaluateProfile();
+        /// Slots of the next generation: those not in the population
+        std::fill(in_population.begin(), in_population.end(), false);
+        for (const Ranked& individual : population)
+            in_population[individual.slot] = true;
+        for (usize slot = 0, i = E; slot < arena.slots(); ++slot) {
+            if (!in_population[slot])
+                next_population[i++].slot = slot;
+        }
 
-            next_population[i].profile = csr.profile;
-            std::swap(next_population[i].labels, csr.labels);
-            std::swap(next_population[i].random_keys, csr.random_keys);
+        /// MUTANTS from the factory (built while the previous generations mated)
+        if (factory) {
+            for (usize i = E; i < E + R; ++i)
+                next_population[i].profile = factory->pop(arena, next_population[i].slot);
         }
 
-        /// MATING
-        for (usize i = (E + R); i < P; ++i) {
-            // Chose biased mates
-            const usize parent1 = distributionElite(getMT());
-            const usize parent2 = distributionPop(getMT());
+        /// MUTANTS AND MATING (one task per slot)
+        // Every slot draws from its own stream of the seed of the generation, so the population does not
+        // depend on the threads; cache lookups only: the values are inserted after the tasks (same hits)
+        const uint64_t generation_seed = getRNG()();
+        const usize first = factory ? E + R : E;
+        parallelTasks(P - first, [&](const usize worker, const usize task) {
+            const usize i = first + task;
+            const usize slot = next_population[i].slot;
+            CSR& ws = workspace(worker);
+            const ScopedRNG stream(streamRNG(generation_seed, i));
+
+            if (i < E + R) {
+                /// MUTANTS (Random solutions)
+                next_population[i].profile = buildMutant(ws);
+            } else {
+                // Chose biased mates
+                const usize parent1 = population[usizeRandomNumber(0, E - 1)].slot;
+                const usize parent2 = population[usizeRandomNumber(0, P - 1)].slot;
 
-            for (usize k = 0; k < csr.m; ++k) {
                 /// Parametrized uniform crossover
-                if (realRK() < PROB) {
-                    csr.random_keys[k] = population[parent1].random_keys[k];
+                // changed: the key differs from the elite parent (for the delta decoder)
+                biasedCrossover(arena.keys(parent1), arena.keys(parent2), ws.random_keys.data(), ws.changed.data(), ws.m, inherit, getRNG());
+
+                Fingerprint* fingerprint = cache.enabled() ? &fingerprints[i] : nullptr;
+                if (DECODER::SORTED && arena.hasLabels()) {
+                    // The labels of the elite parent are its keys sorted
+                    deltaDecoder(ws, arena.labels(parent1), ws.changed, fingerprint);
                 } else {
-                    csr.random_keys[k] = population[parent2].random_keys[k];
+                    DECODER::decode(ws, fingerprint);
                 }
+                if (cache.enabled())
+                    cached[i] = cache.find(fingerprints[i], next_population[i].profile);
+
+                if (improving) {
+                    next_population[i].profile = improve(ws, stats[worker]);
+                } else if (cached[i]) {
+                    // Known labeling
+                } else if (screening) {
+                    next_population[i].profile = ws.estimateProfile() + (OBJ == Objective::Envelope ? ws.m : 0);
+                } else {
+                    next_population[i].profile = evaluate(ws, stats[worker]);
+                }
+            }
+
+            arena.store(slot, ws);
+        }, &work);
+        if (cache.enabled() && !screening) {
+            for (usize i = E + R; i < P; ++i) {
+                if (!cached[i])
+                    cache.insert(fingerprints[i], next_population[i].profile);
             }
+        }
+
+        /// SCREENING (offspring ranked by the estimate)
+        if (screening) {
+            const bool audit_generation = generation % SCREEN_AUDIT == 0;
+            const unsigned long worst_elite = population[E - 1].profile;
+            const realT limit = (1 + opt.screen_slack) * static_cast<realT>(worst_elite);
+            bool promising = true;
+
+            std::iota(offspring.begin(), offspring.end(), E + R);
+            std::sort(offspring.begin(), offspring.end(), [&next_population](const usize a, const usize b) {
+                return next_population[a].profile < next_population[b].profile;
+            });
+
+            audit.clear();
+            for (const usize i : offspring) {
+                // Exact value from the cache
+                if (cached[i])
+                    continue;
+                const unsigned long estimate = next_population[i].profile;
+                promising = promising && static_cast<realT>(estimate) <= limit;
+                ++n_offspring;
+
+                if (promising || audit_generation) {
+                    labelsOf(next_population[i].slot, csr);
+                    const unsigned long exact = evaluate(csr, stats[0]);
+                    next_population[i].profile = exact;
+                    ++n_exact;
+                    if (cache.enabled())
+                        cache.insert(fingerprints[i], exact);
 
-            decoder(csr);
-            csr.evaluateProfile();
+                    if (audit_generation) {
+                        audit.push_back({estimate, exact});
+                        if (!promising && exact <= worst_elite)
+                            ++n_missed;
+                    }
+                } else {
+                    // Can not enter the elite set
+                    next_population[i].profile = std::max(estimate, worst_elite + 1);
+                }
+            }
 
-            next_population[i].profile = csr.profile;
-            std::swap(next_population[i].random_keys, csr.random_keys);
-            std::swap(next_population[i].labels, csr.labels);
+            if (audit_generation) {
+                sum_tau += kendallTau(audit);
+                ++n_audits;
+            }
         }
 
-        /// ELITISM 
-        std::move(population.begin(), population.begin() + E, next_population.begin());
+        /// ELITISM (the elite keep their slots)
+        std::copy(population.begin(), population.begin() + E, next_population.begin());
+
+        /// Relative gap to the lower bound (reported on every improvement)
+        const unsigned long best = std::min_element(next_population.begin(), next_population.end())->profile;
+        if (best < best_known) {
+            best_known = best;
+            gap = lower_bound >= best ? 0 : static_cast<realT>(best - lower_bound) / static_cast<realT>(best);
+            if (opt.verbose)
+                std::cout << "Generation " << generation << ": " << best << " (gap " << 100 * gap << "%)\n";
+        }
 
-        /// Check the time limit
-        if (std::chrono::steady_clock::now() - start > csr.max_time) {
+        /// Check the time limit and the gap (of any island)
+        if (migration != nullptr && gap <= opt.gap)
+            migration->stop();
+        const bool stopped = migration != nullptr && migration->stopped();
+        if (std::chrono::steady_clock::now() - start > csr.max_time || gap <= opt.gap || stopped) {
             sort(next_population.begin(), next_population.end());
-            const usize current_profile = static_cast<usize>(next_population[0].profile);
-            if (current_profile < csr.best_profile)
-                csr.best_profile = current_profile;
-            csr.profile = csr.best_profile;
-            return;
+            result.best = next_population[0].profile;
+            result.generations = generation + 1;
+            result.time = std::chrono::steady_clock::now() - start;
+            finishPopulation<DECODER>(csr, arena, next_population[0]);
+
+            if (opt.verbose && screening) {
+                std::cout << "\nScreening: " << csr.sample_rows.size() << " sampled rows, "
+                          << n_exact << " of " << n_offspring << " offspring evaluated, "
+                          << "Kendall tau (estimate x exact) " << sum_tau / std::max<usize>(n_audits, 1)
+                          << " in " << n_audits << " audits, " << n_missed << " elite candidates missed\n";
+            }
+            if (opt.verbose) {
+                reportStats(stats, cache, improving);
+                reportWorkers(work, result.time);
+                if (factory)
+                    reportFactory(*factory);
+            }
+            return result;
         }
 
-        /// EVOLVE (swap pointers)
+        /// EVOLVE (swap the rankings)
         std::swap(population, next_population);
+        ++generation;
+    }
+}
+
+// Steady-state BRKGA-Pr on csr (its best individual is left in csr): no generations nor barriers
+// Every worker repeatedly builds a mutant or an offspring of the current ranking and offers it to the shared
+// pool, where it replaces the worst individual if it is better (mutants always replace it). The time limit
+// and the gap are checked before each individual. P - E individuals count as a generation (migration, report)
+// With one worker and a fixed SEED the run is reproducible; with more, it depends on the timing of the workers
+template <Objective OBJ, typename DECODER>
+PopulationResult brkgaSteady(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt,
+                             const unsigned long lower_bound, Migration* migration, const usize island) {
+    csr.random_keys.resize(csr.m);
+    csr.tmp_rk.resize(csr.m);
+    csr.indexed_rk.resize(csr.m);
+    csr.changed.resize(csr.m);
+    const BernoulliMask inherit(PROB);
+    PopulationResult result;
+    const usize n_migrants = std::min({opt.migrants, E, P - E});
+    const unsigned long migration_period = static_cast<unsigned long>(opt.migration) * (P - E);
+
+    /// Pool: the P individuals of the initial population and one slot under construction per worker
+    const usize n_workers = numWorkers(P - E);
+    PopulationArena arena(P + n_workers, csr.m, !opt.lean);
+    std::vector<Ranked> initial(P);
+    initPopulation<OBJ, DECODER>(csr, INIT, arena, initial, P);
+    RankedPool pool(std::move(initial), E, arena.slots());
+    if (opt.verbose) {
+        std::cout << "Population memory: " << static_cast<realT>(arena.bytes()) / (1 << 20) << " MiB ("
+                  << arena.slots() << (arena.hasLabels() ? " slots of keys and labels)\n" : " slots of keys)\n");
+        std::cout << "Workers: " << n_workers << " (steady state)\n";
+    }
+
+    /// Screening, improvement and cache as in brkgaPopulation (screening without audits)
+    constexpr bool PROFILE_BASED = OBJ == Objective::Profile || OBJ == Objective::Envelope;
+    constexpr bool IMPROVABLE = PROFILE_BASED && DECODER::SORTED;
+    const bool improving = IMPROVABLE && opt.improve > 0;
+    const auto improve_cap = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::duration<realT, std::milli>(opt.improve));
+    const bool screening = PROFILE_BASED && opt.screen > 0 && !improving;
+    if (screening)
+        csr.sampleRows(static_cast<usize>(std::ceil(opt.screen * csr.m)));
+    std::atomic<unsigned long> n_offspring{0}, n_exact{0};
+    FitnessCache cache(improving ? 0 : opt.cache);
+
+    /// Workers (each one on its own workspace and slot of the arena, as in brkgaPopulation)
+    std::vector<CSR> workspaces(n_workers - 1, csr);
+    std::vector<WorkerStats> stats(n_workers);
+    std::vector<TaskStats> work(n_workers); // Scheduling of the tasks (busy time of each worker)
+    const auto workspace = [&csr, &workspaces](const usize worker) -> CSR& {
+        return worker == 0 ? csr : workspaces[worker - 1];
+    };
+    const MutantBuilder<OBJ, DECODER> buildMutant{INIT};
+    const auto factory = mutantFactory<OBJ, DECODER>(csr, R, INIT, opt);
+
+    /// Best individual and gap (reported on every improvement)
+    std::mutex report_lock, migration_lock;
+    std::atomic<unsigned long> best_known{pool.best()};
+    realT gap = lower_bound >= best_known ? 0 : static_cast<realT>(best_known - lower_bound) / static_cast<realT>(best_known);
+    std::atomic<bool> stop{gap <= opt.gap};
+
+    const auto start = std::chrono::steady_clock::now();
+    std::atomic<unsigned long> produced{0};
+    const uint64_t steady_seed = getRNG()();
+    parallelTasks(n_workers, [&](const usize worker, const usize task) {
+        CSR& ws = workspace(worker);
+        WorkerStats& st = stats[worker];
+        const ScopedRNG stream(streamRNG(steady_seed, task));
+        usize own = P + task; // Slot of the individual under construction
+
+        // Offer the individual in own (written once its readers are gone) and take the slot returned
+        const auto offer = [&](const unsigned long value, const bool forced) {
+            own = pool.offer({value, own}, forced);
+            pool.acquire(own);
+        };
+
+        for (unsigned long t = produced++; !stop.load(std::memory_order_relaxed); t = produced++) {
+            if (std::chrono::steady_clock::now() - start > csr.max_time || (migration != nullptr && migration->stopped()))
+                break;
+
+            unsigned long value;
+            const bool mutant = t % (P - E) < R;
+            if (mutant && factory) {
+                /// MUTANT from the factory
+                value = factory->pop(arena, own);
+            } else if (mutant) {
+                /// MUTANT (Random solution)
+                value = buildMutant(ws);
+                arena.store(own, ws);
+            } else {
+                /// OFFSPRING of a random elite individual and a random individual (pinned while read)
+                const Ranked parent1 = pool.pin(usizeRandomNumber(0, E - 1));
+                const Ranked parent2 = pool.pin(usizeRandomNumber(0, P - 1));
+                biasedCrossover(arena.keys(parent1.slot), arena.keys(parent2.slot), ws.random_keys.data(), ws.changed.data(), ws.m, inherit, getRNG());
+                pool.release(parent2.slot);
+
+                Fingerprint fingerprint;
+                Fingerprint* fp = cache.enabled() ? &fingerprint : nullptr;
+                if (DECODER::SORTED && arena.hasLabels()) {
+                    deltaDecoder(ws, arena.labels(parent1.slot), ws.changed, fp);
+                } else {
+                    DECODER::decode(ws, fp);
+                }
+                pool.release(parent1.slot);
+
+                if (improving) {
+                    value = improveOffspring<OBJ, DECODER>(ws, st, improve_cap);
+                } else if (cache.enabled() && cache.find(fingerprint, value)) {
+                    // Known labeling
+                } else {
+                    bool exact = true;
+                    if (screening) {
+                        // Only offspring that may enter the elite set are evaluated
+                        const unsigned long estimate = ws.estimateProfile() + (OBJ == Objective::Envelope ? ws.m : 0);
+                        const unsigned long worst_elite = pool.worstElite();
+                        exact = static_cast<realT>(estimate) <= (1 + opt.screen_slack) * static_cast<realT>(worst_elite);
+                        value = std::max(estimate, worst_elite + 1);
+                        ++n_offspring;
+                        n_exact += exact;
+                    }
+                    if (exact) {
+                        value = evaluateTimed<OBJ>(ws, st);
+                        if (cache.enabled())
+                            cache.insert(fingerprint, value);
+                    }
+                }
+                arena.store(own, ws);
+            }
+            offer(value, mutant);
+
+            if (value < best_known.load(std::memory_order_relaxed)) {
+                const std::lock_guard lock(report_lock);
+                if (value < best_known) {
+                    best_known = value;
+                    gap = lower_bound >= value ? 0 : static_cast<realT>(value - lower_bound) / static_cast<realT>(value);
+                    if (opt.verbose)
+                        std::cout << "Generation " << t / (P - E) << ": " << value << " (gap " << 100 * gap << "%)\n";
+                    if (gap <= opt.gap) {
+                        stop = true;
+                        if (migration != nullptr)
+                            migration->stop();
+                    }
+                }
+            }
+
+            /// MIGRATION (every opt.migration generations, by the worker of that individual)
+            if (migration != nullptr && n_migrants > 0 && t > 0 && t % migration_period == 0) {
+                // One migration at a time: send and receive are single-threaded per island (see Migration)
+                const std::lock_guard migrating(migration_lock);
+                std::vector<SolutionRK> emigrants(n_migrants);
+                for (usize j = 0; j < n_migrants; ++j) {
+                    const Ranked emigrant = pool.pin(j);
+                    emigrants[j] = arena.solution(emigrant.slot, emigrant.profile);
+                    pool.release(emigrant.slot);
+                }
+                migration->send(island, std::move(emigrants));
+
+                std::vector<SolutionRK> migrants = migration->receive(island);
+                const usize n_received = std::min<usize>(migrants.size(), n_migrants);
+                for (usize j = 0; j < n_received; ++j) {
+                    if (migrants[j].labels.empty() && arena.hasLabels()) {
+                        std::swap(migrants[j].random_keys, ws.random_keys);
+                        DECODER::decode(ws);
+                        arena.store(own, ws);
+                    } else {
+                        arena.store(own, migrants[j]);
+                    }
+                    // Migrants replace the worst individuals
+                    offer(migrants[j].profile, true);
+                }
+                const std::lock_guard lock(report_lock);
+                result.immigrants += n_received;
+            }
+        }
+    }, &work);
+
+    const std::vector<Ranked> ranking = pool.snapshot();
+    result.best = ranking[0].profile;
+    result.generations = static_cast<usize>(produced / (P - E));
+    result.time = std::chrono::steady_clock::now() - start;
+    if (opt.check)
+        checkInvariants<OBJ, DECODER>(csr, arena, ranking, E, screening, result.generations);
+    finishPopulation<DECODER>(csr, arena, ranking[0]);
+
+    if (opt.verbose) {
+        std::cout << "\nSteady state: " << pool.accepted << " of " << pool.accepted + pool.rejected
+                  << " individuals entered the population\n";
+        if (screening) {
+            std::cout << "\nScreening: " << csr.sample_rows.size() << " sampled rows, " << n_exact << " of "
+                      << n_offspring << " offspring evaluated\n";
+        }
+        reportStats(stats, cache, improving);
+        reportWorkers(work, result.time);
+        if (factory)
+            reportFactory(*factory);
+    }
+    return result;
+}
+
+// Evolve one population with the engine of opt (generational or steady state)
+// The producers of the mutant factory are part of num_threads: the parallel loops use the other threads
+template <Objective OBJ, typename DECODER>
+PopulationResult evolvePopulation(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt,
+                                  const unsigned long lower_bound, Migration* migration, const usize island) {
+    const usize producers = R > 0 ? opt.producers : 0;
+    const ScopedThreads loops(num_threads > producers ? num_threads - producers : 1);
+    if (opt.steady)
+        return brkgaSteady<OBJ, DECODER>(csr, P, E, R, PROB, INIT, opt, lower_bound, migration, island);
+    return brkgaPopulation<OBJ, DECODER>(csr, P, E, R, PROB, INIT, opt, lower_bound, migration, island);
+}
+
+// BRKGA-Pr minimizing the objective OBJ, decoding the keys with DECODER (see decoders.hpp)
+// One population, or opt.islands populations evolving concurrently on their own threads and copies of csr
+// (their own buffers on the graph of csr, see CSR)
+// With a migration, one island of it (island processes, see processes.cpp)
+template <Objective OBJ, typename DECODER>
+void brkgaObjective(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt,
+                    Migration* migration, const usize island) {
+    /// Lower bound of the objective
+    const auto lb_start = std::chrono::steady_clock::now();
+    const unsigned long lower_bound = csr.lowerBounds().value(OBJ);
+    if (opt.verbose) {
+        const auto lb_time = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - lb_start);
+        std::cout << "Lower bound: " << lower_bound << " (" << lb_time.count() << " ms)\n";
+    }
+
+    DECODER::prepare(csr);
+    if (opt.islands <= 1 || migration != nullptr) {
+        evolvePopulation<OBJ, DECODER>(csr, P, E, R, PROB, INIT, opt, lower_bound, migration, island);
+        return;
+    }
+
+    /// Islands (island 0 on the calling thread and csr, each one on its own stream of random numbers)
+    // The slots of a generation of an island run serially (see parallelTasks): the islands and their
+    // producers take serialThreads(opt) threads (main checks that they fit in num_threads)
+    const usize n_islands = opt.islands;
+    ThreadMigration archipelago(n_islands, opt.topology);
+    // Workspaces of the other islands: the graph is shared, only the buffers (prepared above) are copied
+    std::vector<CSR> island_csr(n_islands - 1, csr);
+    std::vector<PopulationResult> results(n_islands);
+    BRKGAOptions island_opt = opt;
+    island_opt.verbose = false;
+    const uint64_t islands_seed = getRNG()();
+    const auto evolve = [&](const usize island) {
+        runParallel([&] {
+            const ScopedRNG stream(streamRNG(islands_seed, island));
+            results[island] = evolvePopulation<OBJ, DECODER>(island == 0 ? csr : island_csr[island - 1], P, E, R, PROB, INIT,
+                                                             island_opt, lower_bound, &archipelago, island);
+        });
+    };
+    std::vector<std::thread> threads;
+    threads.reserve(n_islands - 1);
+    for (usize island = 1; island < n_islands; ++island)
+        threads.emplace_back(evolve, island);
+    evolve(0);
+    for (auto& t : threads)
+        t.join();
+
+    /// Best island (its best individual into csr)
+    usize best = 0;
+    for (usize island = 1; island < n_islands; ++island) {
+        if (results[island].best < results[best].best)
+            best = island;
+    }
+    if (best > 0) {
+        const CSR& winner = island_csr[best - 1];
+        csr.labels = winner.labels;
+        invertLabels(csr);
+        csr.profile = winner.profile;
+        csr.best_profile = winner.best_profile;
+    }
+
+    if (opt.verbose) {
+        for (usize island = 0; island < n_islands; ++island) {
+            const PopulationResult& r = results[island];
+            const realT seconds = std::chrono::duration<realT>(r.time).count();
+            std::cout << "Island " << island << ": best " << r.best << ", " << r.generations << " generations ("
+                      << (seconds > 0 ? r.generations / seconds : 0) << " per second), " << r.immigrants << " immigrants received, "
+                      << archipelago.discarded(island) << " migrations discarded\n";
+        }
+        std::cout << "Best island: " << best << '\n';
     }
 }
 
-// Initial population
-void initPopulation(CSR& csr, const usize INIT, std::vector<SolutionRK>& population, const usize N) {
-    encoder(csr);
-    population[0].profile = csr.profile;
-    population[0].labels = csr.labels;
-    population[0].random_keys = csr.random_keys;
+// Initial population (slots 0 to N - 1 of the arena)
+template <Objective OBJ, typename DECODER>
+void initPopulation(CSR& csr, const usize INIT, PopulationArena& arena, std::vector<Ranked>& population, const usize N) {
+    // The labels of csr as the individual i
+    const auto add = [&](const usize i) {
+        DECODER::encode(csr);
+        population[i] = {csr.evaluateObjective<OBJ>(), i};
+        arena.store(i, csr);
+    };
+    add(0);
 
     /// Sloan-MGPS
     csr.sloanMGPS();
-    encoder(csr);
-    csr.evaluateProfile();
-    population[1].profile = csr.profile;
-    population[1].labels = csr.labels;
-    population[1].random_keys = csr.random_keys;
+    add(1);
     csr.sloanMGPS();
-    encoder(csr);
-    csr.evaluateProfile();
-    population[2].profile = csr.profile;
-    population[2].labels = csr.labels;
-    population[2].random_keys = csr.random_keys;
+    add(2);
     csr.sloanMGPS();
-    encoder(csr);
-    csr.evaluateProfile();
-    population[3].profile = csr.profile;
-    population[3].labels = csr.labels;
-    population[3].random_keys = csr.random_keys;
+    add(3);
 
     /// ML1W-SM (SloanMGPS label the coarsest graph)
     const usize algo_base = 0;
     csr.msW({}, algo_base);
-    encoder(csr);
-    csr.evaluateProfile();
-    population[4].profile = csr.profile;
-    population[4].labels = csr.labels;
-    population[4].random_keys = csr.random_keys;
+    add(4);
     csr.msW({}, algo_base);
-    encoder(csr);
-    csr.evaluateProfile();
-    population[5].profile = csr.profile;
-    population[5].labels = csr.labels;
-    population[5].random_keys = csr.random_keys;
+    add(5);
     csr.msW({}, algo_base);
-    encoder(csr);
-    csr.evaluateProfile();
-    population[6].profile = csr.profile;
-    population[6].labels = csr.labels;
-    population[6].random_keys = csr.random_keys;
+    add(6);
 
     /// MPG
     csr.mpg();
-    encoder(csr);
-    csr.evaluateProfile();
-    population[7].profile = csr.profile;
-    population[7].labels = csr.labels;
-    population[7].random_keys = csr.random_keys;
+    add(7);
 
     for (usize i = 8; i < N; ++i) {
         if (INIT == 0) {
@@ -151,12 +799,63 @@ void initPopulation(CSR& csr, const usize INIT, std::vector<SolutionRK>& populat
         } else {
             csr.msWConstrutiveSM({});
         }
+        add(i);
+    }
+}
+
+// BRKGA-Pr minimizing OBJ with the decoder of opt
+template <Objective OBJ>
+void brkgaDecoder(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt,
+                  Migration* migration, const usize island) {
+    switch (opt.decoder) {
+        case Decoder::Sort:
+            brkgaObjective<OBJ, SortDecoder>(csr, P, E, R, PROB, INIT, opt, migration, island);
+            break;
+        case Decoder::Level:
+            brkgaObjective<OBJ, LevelDecoder>(csr, P, E, R, PROB, INIT, opt, migration, island);
+            break;
+        case Decoder::Sloan:
+            brkgaObjective<OBJ, SloanDecoder>(csr, P, E, R, PROB, INIT, opt, migration, island);
+            break;
+    }
+}
 
-        encoder(csr);
-        csr.evaluateProfile();
+/**** BRKGA-Pr
+@param P: Population size
+@param E: Elite set size
+@param R: Number of mutant individuals (new solutions)
+@param PROB: Probability of inheriting the key from the elite parent
+@param INIT: Constructive method for the initial population
+@param opt: Optional features (see BRKGAOptions)
+@param migration: Migration of the island processes (see processes.cpp), csr evolves the island `island`
+*/
+void brkga(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt,
+           Migration* migration, const usize island) {
+    if (opt.runs > 1 && migration == nullptr) {
+        brkgaRuns(csr, P, E, R, PROB, INIT, opt);
+        return;
+    }
+    if (opt.processes > 1 && migration == nullptr) {
+        brkgaProcesses(csr, P, E, R, PROB, INIT, opt);
+        return;
+    }
 
-        population[i].profile = csr.profile;
-        population[i].random_keys = csr.random_keys;
-        population[i].labels = csr.labels;
+    // One instance per objective and decoder, the evaluation computes only the metrics it needs
+    switch (opt.objective) {
+        case Objective::Profile:
+            brkgaDecoder<Objective::Profile>(csr, P, E, R, PROB, INIT, opt, migration, island);
+            break;
+        case Objective::Bandwidth:
+            brkgaDecoder<Objective::Bandwidth>(csr, P, E, R, PROB, INIT, opt, migration, island);
+            break;
+        case Objective::MaxWavefront:
+            brkgaDecoder<Objective::MaxWavefront>(csr, P, E, R, PROB, INIT, opt, migration, island);
+            break;
+        case Objective::RmsWavefront:
+            brkgaDecoder<Objective::RmsWavefront>(csr, P, E, R, PROB, INIT, opt, migration, island);
+            break;
+        case Objective::Envelope:
+            brkgaDecoder<Objective::Envelope>(csr, P, E, R, PROB, INIT, opt, migration, island);
+            break;
     }
 }
\ No newline at end of file
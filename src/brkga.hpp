@@ -2,8 +2,38 @@
 #define BRKGA_H
 
 #include "misc.hpp"
-#include "random_keys.hpp"
+#include "decoders.hpp"
+#include "parallel.hpp"
+#include "migration.hpp"
+#include "population.hpp"
 
+// Optional features of the BRKGA-Pr (defaults reproduce the plain algorithm)
+struct BRKGAOptions {
+    realT screen = 0; // Fraction of rows sampled to screen offspring (0 = every offspring is evaluated)
+    realT screen_slack = 0.05; // Offspring with estimate <= (1 + slack) * worst elite are evaluated
+    Objective objective = Objective::Profile; // Objective function
+    Decoder decoder = Decoder::Sort; // Decoding of the keys into labels
+    usize cache = 0; // log2 of the slots of the fitness cache (0 = no cache)
+    realT improve = 0; // Time cap (ms) of the local improvement of each offspring (0 = no improvement)
+    usize islands = 1; // Populations evolving concurrently, one per thread (1 = a single population)
+    usize migration = 10; // Generations between migrations of the islands
+    usize migrants = 2; // Best individuals sent by an island in each migration
+    Topology topology = Topology::Ring; // Destination of the migrants
+    usize processes = 1; // Island processes (fork), pinned to disjoint sets of CPUs (1 = no processes)
+    usize runs = 1; // Independent runs on the graph loaded once, the best one is returned (multi-start)
+    usize producers = 0; // Background threads building mutants ahead of their use, taken from num_threads (0 = mutants built when needed)
+    bool steady = false; // Steady-state engine: no generations, offspring replace the worst individual as they are built
+    bool lean = false; // Store only the keys of the population (labels decoded when needed)
+    realT gap = 0; // Stop when the relative gap (best - lower bound) / best is <= gap
+    bool check = false; // Check the invariants of the population in every generation
+    bool verbose = false; // Print run statistics
+};
+
+// Threads of a population that evolves serially (a run, or an island), with its producers, times the islands
+// of opt: the share of --threads that brkga needs when it runs inside a parallel loop
+inline usize serialThreads(const BRKGAOptions& opt) {
+    return std::max<usize>(opt.islands, 1) * (1 + opt.producers);
+}
 
 /**** BRKGA-Pr
 @param P: Population size
@@ -11,9 +41,19 @@
 @param R: Number of mutant individuals (new solutions)
 @param PROB: Probability of inheriting the key from the elite parent
 @param INIT: Constructive method for the initial population
+@param opt: Optional features (see BRKGAOptions)
+@param migration: Migration of the island processes (see processes.cpp), csr evolves the island `island`
 */
-void brkga(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT);
+void brkga(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt = {},
+           Migration* migration = nullptr, const usize island = 0);
+
+// BRKGA-Pr on opt.processes island processes migrating through shared memory (best solution in csr)
+void brkgaProcesses(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt);
+
+// opt.runs independent runs of the BRKGA-Pr sharing the loaded graph (best solution in csr, see runs.cpp)
+void brkgaRuns(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt);
 
-void initPopulation(CSR& csr, const usize INIT_V, std::vector<SolutionRK>& population, const usize N);
+template <Objective OBJ, typename DECODER>
+void initPopulation(CSR& csr, const usize INIT_V, PopulationArena& arena, std::vector<Ranked>& population, const usize N);
 
 #endif
\ No newline at end of file
@@ -1,9 +1,8 @@
 #include "csr.hpp"
+#include "parallel.hpp"
+#include <atomic>
 
-CSR::CSR(usize rows, usize nnz) : m(rows), n_nz(nnz) {
-    row_index.reserve(rows + 1);
-    col_index.reserve(nnz);
-}
+CSR::CSR(usize rows, usize nnz) : m(rows), n_nz(nnz) {}
 
 CSR::CSR(const std::string& path, bool f_symmetric) {
     std::ifstream file(path);
@@ -119,29 +118,30 @@ CSR::CSR(const std::string& path, bool f_symmetric) {
     element_list.erase(last, element_list.end());
 
     // Populate CSR row_index and col_index based on sorted elements
-    col_index.resize(element_list.size());
-    row_index.resize(m + 1);
+    Graph g;
+    g.col_index.resize(element_list.size());
+    g.row_index.resize(m + 1);
     n_nz = element_list.size();  
 
     // Variables to track row indexing
     usize current_row = 0;
-    row_index[0] = 0;
+    g.row_index[0] = 0;
 
     for (usize i = 0; i < element_list.size(); i++) {
         const Element& e = element_list[i];
         // Column index
-        col_index[i] = e.j;
+        g.col_index[i] = e.j;
 
         // If current element's row index is greater than the current row
         while (current_row < e.i) {
-            row_index[current_row + 1] = i;
+            g.row_index[current_row + 1] = i;
             current_row++;
         }
     }
 
     // Fill remaining row_index entries
     for (usize i = current_row + 1; i <= m; i++) {
-        row_index[i] = n_nz;
+        g.row_index[i] = n_nz;
     }
 
     // Fill Labels
@@ -149,21 +149,29 @@ CSR::CSR(const std::string& path, bool f_symmetric) {
     iota(labels.begin(), labels.end(), 0);
 
     /// Degrees
-    degree.resize(m);
+    g.degree.resize(m);
     min_degree = std::numeric_limits<usize>::max();
     for (usize i = 0; i < m; i++) {
-        degree[i] = row_index[i + 1] - row_index[i];
-        if (degree[i] > max_degree)
-            max_degree = degree[i];
+        g.degree[i] = g.row_index[i + 1] - g.row_index[i];
+        if (g.degree[i] > max_degree)
+            max_degree = g.degree[i];
 
-        if (degree[i] < min_degree)
-            min_degree = degree[i];
+        if (g.degree[i] < min_degree)
+            min_degree = g.degree[i];
     }
+    setGraph(std::move(g));
 
     distances.resize(m);
     visited.resize(m);
 }
 
+void CSR::setGraph(Graph g) {
+    graph = std::make_shared<const Graph>(std::move(g));
+    col_index = graph->col_index;
+    row_index = graph->row_index;
+    degree = graph->degree;
+}
+
 
 // Breadth-First Search (BFS) 
 // Modified for finding the distances of all vertices to v
@@ -196,12 +204,31 @@ void CSR::bfs(usize v) {
 
 // Evaluate profile
 void CSR::evaluateProfile() {
+    evaluateOrdering<METRIC_PROFILE>();
+}
+
+// Evaluate the metrics of labels selected by METRICS in a single pass
+// Row i spans the labels [f_i, l_i], where f_i is the smallest label in its closed neighbourhood
+// Width (l_i - f_i): profile (sum) and bandwidth (max)
+// Row i is active in the elimination steps f_i..l_i: wavefront of each step (max and RMS)
+template <unsigned METRICS>
+void CSR::evaluateOrdering() {
+    constexpr bool PROFILE = (METRICS & (METRIC_PROFILE | METRIC_ENVELOPE)) != 0;
+    constexpr bool BANDWIDTH = (METRICS & METRIC_BANDWIDTH) != 0;
+    constexpr bool WAVEFRONT = (METRICS & METRIC_WAVEFRONT) != 0;
     usize small_neighbor_label;
-    profile = 0;
+    unsigned long total = 0;
+    usize bandwidth = 0;
+
+    if constexpr (WAVEFRONT)
+        wavefront_delta.assign(m + 1, 0);
 
     for (usize i = 0; i < m; i++) {
         const usize li = labels[i];
-        if (li == 0) continue;  // if the LABEL is 0
+        // if the LABEL is 0 (row 0 is still active in step 0 for the wavefront)
+        if constexpr (!WAVEFRONT) {
+            if (li == 0) continue;
+        }
         small_neighbor_label = li;
         /// For each neighbor of i
         for (usize j_idx = row_index[i]; j_idx < row_index[i + 1]; j_idx++) {
@@ -213,11 +240,90 @@ void CSR::evaluateProfile() {
             if (small_neighbor_label == 0)
                 break;
         }
-        profile += li - small_neighbor_label;
+
+        const usize width = li - small_neighbor_label;
+        if constexpr (PROFILE)
+            total += width;
+        if constexpr (BANDWIDTH)
+            bandwidth = std::max(bandwidth, width);
+        if constexpr (WAVEFRONT) {
+            // Unsigned wrap-around is fine, the prefix sums are never negative
+            ++wavefront_delta[small_neighbor_label];
+            --wavefront_delta[li + 1];
+        }
+    }
+
+    metrics.m = m;
+    if constexpr (PROFILE) {
+        profile = total;
+        metrics.profile = total;
+        metrics.envelope = total + m;
+
+        if (profile < best_profile) 
+            best_profile = profile;
+    }
+    if constexpr (BANDWIDTH)
+        metrics.bandwidth = bandwidth;
+    if constexpr (WAVEFRONT) {
+        usize wavefront = 0;
+        metrics.max_wavefront = 0;
+        metrics.sum_sq_wavefront = 0;
+        for (usize k = 0; k < m; ++k) {
+            wavefront += wavefront_delta[k];
+            metrics.max_wavefront = std::max(metrics.max_wavefront, wavefront);
+            metrics.sum_sq_wavefront += static_cast<unsigned long>(wavefront) * wavefront;
+        }
+    }
+}
+
+// Metric sets used by evaluateObjective and for reporting
+template void CSR::evaluateOrdering<METRIC_PROFILE>();
+template void CSR::evaluateOrdering<METRIC_BANDWIDTH>();
+template void CSR::evaluateOrdering<METRIC_WAVEFRONT>();
+template void CSR::evaluateOrdering<METRIC_ENVELOPE>();
+template void CSR::evaluateOrdering<METRIC_ALL>();
+
+// Draw a stratified sample of rows (one row per stratum) for estimateProfile
+// The adjacency of the sampled rows is copied into a compact CSR
+void CSR::sampleRows(const usize SIZE) {
+    const usize n_strata = std::clamp<usize>(SIZE, 1, m);
+    sample_rows.resize(n_strata);
+    sample_row_index.assign(n_strata + 1, 0);
+    sample_col_index.clear();
+
+    for (usize s = 0; s < n_strata; ++s) {
+        // Stratum s covers the rows [first, last)
+        const usize first = static_cast<usize>((static_cast<unsigned long>(s) * m) / n_strata);
+        const usize last = static_cast<usize>((static_cast<unsigned long>(s + 1) * m) / n_strata);
+        const usize i = usizeRandomNumber(first, last - 1);
+
+        sample_rows[s] = i;
+        sample_col_index.insert(sample_col_index.end(), col_index.begin() + row_index[i], col_index.begin() + row_index[i + 1]);
+        sample_row_index[s + 1] = sample_col_index.size();
+    }
+    sample_col_index.shrink_to_fit();
+
+    sample_scale = static_cast<realT>(m) / static_cast<realT>(n_strata);
+}
+
+// Estimate the profile of labels from the sampled rows
+// Same row width as evaluateProfile, scaled by the stratum size
+unsigned long CSR::estimateProfile() const {
+    unsigned long sampled = 0;
+
+    for (usize s = 0; s < sample_rows.size(); ++s) {
+        const usize li = labels[sample_rows[s]];
+        if (li == 0) continue;
+        usize small_neighbor_label = li;
+        for (usize j_idx = sample_row_index[s]; j_idx < sample_row_index[s + 1]; ++j_idx) {
+            small_neighbor_label = std::min(small_neighbor_label, labels[sample_col_index[j_idx]]);
+            if (small_neighbor_label == 0)
+                break;
+        }
+        sampled += li - small_neighbor_label;
     }
 
-    if (profile < best_profile) 
-        best_profile = profile;
+    return static_cast<unsigned long>(static_cast<realT>(sampled) * sample_scale);
 }
 
 // Get vertices from the last level structure and eccentricity
@@ -297,31 +403,42 @@ usize CSR::getDiameter() {
 }
 
 bool CSR::isFeasible() const {
-    std::set<usize> unique_elements(labels.begin(), labels.end());
-    
-    if (unique_elements.size() != labels.size()) {
-        std::cerr << "\n Labels are not unique!" << std::endl;
-        return false;
-    }        
-    
-    if (*unique_elements.begin() != 0) {
-        std::cerr << "\n Labels do not start from 0!" << std::endl;
+    if (labels.size() != m) {
+        std::cerr << "\n Labels do not have m elements!" << std::endl;
         return false;
     }
 
-    if (*prev(unique_elements.end()) != (m - 1)) {
-        std::cerr << "\n Labels do not end in m - 1!" << std::endl;
+    if (!isPermutation(labels, m)) {
+        std::cerr << "\n Labels are not a permutation of [0, m - 1]!" << std::endl;
         return false;
     }
-    
-    usize l = 0;
-    for (auto it = unique_elements.begin(); it != unique_elements.end(); ++it) {
-        if (*it != l) {
-            std::cerr << "\n Labels are not continuous!" << std::endl;
-            return false;
-        }
-        ++l;
-    }
 
     return true;
 }
+
+// Verify if labels is a permutation of [0, m)
+// Each label sets its bit in a bitmap, a bit already set is a repeated label
+bool isPermutation(const std::vector<usize>& labels, const usize m) {
+    constexpr usize GRAIN = 1 << 16;
+    if (labels.size() != m)
+        return false;
+
+    std::vector<std::atomic<uint64_t>> seen((m + 63) / 64);
+    std::atomic<bool> valid{true};
+    parallelFor(m, GRAIN, [&](const usize, const usize begin, const usize end) {
+        for (usize i = begin; i < end; ++i) {
+            const usize l = labels[i];
+            if (l >= m) {
+                valid.store(false, std::memory_order_relaxed);
+                return;
+            }
+            const uint64_t bit = uint64_t(1) << (l % 64);
+            if (seen[l / 64].fetch_or(bit, std::memory_order_relaxed) & bit) {
+                valid.store(false, std::memory_order_relaxed);
+                return;
+            }
+        }
+    });
+
+    return valid.load();
+}
\ No newline at end of file
@@ -5,20 +5,53 @@
 #include "misc.hpp"
 #include "max_heap_robin_hood.hpp"
 #include "max_heap_real.hpp"
+#include <memory>
+#include <span>
 
+// Arrays of a graph, shared read-only by the copies of its CSR
+struct Graph {
+    std::vector<usize> col_index; // Column indices of non-zero entries
+    std::vector<usize> row_index; // Row index pointers
+    std::vector<usize> degree; // Degre of vertices
+};
+
+// Graph (shared by the copies, see setGraph) and the buffers of the heuristics, decoders and encoders
+// A copy is a workspace on the same graph: it copies only the buffers
 class CSR {
 public:
     std::vector<IndexedElement> indexed_rk; // Store the RK and its original index
-    std::vector<realT> random_keys; // Representation using Random Keys
-    std::vector<realT> tmp_rk;  // Aux vector used in the encoder (random_keys.cpp) and in psiVertices
+    std::vector<IndexedElement> radix_rk; // Scratch of the radix sort in the decoder (swapped with indexed_rk)
+    std::vector<IndexedElement> delta_rk; // Changed keys of an offspring in the delta decoder
+    std::vector<char> changed; // Keys of an offspring not inherited from the elite parent (delta decoder)
+    std::vector<rkT> random_keys; // Representation using Random Keys
+    std::vector<rkT> tmp_rk;  // Aux vector used in the encoder (random_keys.cpp) and in psiVertices
+    std::vector<realT> priority; // Keys as priorities (sloanDecoder)
+    std::pair<usize, usize> decoder_pp; // Pseudoperipheral pair of sloanDecoder (computed once)
+    bool has_decoder_pp = false;
+    std::vector<usize> level_queue; // BFS queue of levelDecoder
+    /// Workspace of sloanMGPSPriority (sized once and reused by sloanDecoder)
+    std::vector<VertexDataReal> sloan_vertices;
+    std::vector<VertexCostReal> sloan_queue;
+    robin_hood::unordered_map<usize, usize> sloan_idx;
     /*************/
-    std::vector<usize> col_index; // Column indices of non-zero entries
-    std::vector<usize> row_index; // Row index pointers
+    std::span<const usize> col_index; // Column indices of non-zero entries (in graph)
+    std::span<const usize> row_index; // Row index pointers (in graph)
     std::vector<usize> labels; // Labels of vertices
-    std::vector<usize> degree; // Degre of vertices
+    std::vector<usize> inverse; // Inverse of labels (kept by the decoders and encoders, see invertLabels)
+    std::span<const usize> degree; // Degre of vertices (in graph)
     std::vector<char> visited; // Visited vertices
     std::vector<usize> distances; // Distances
     std::vector<usize> reduced_n; // Reduced neighbourhood for LS
+    /// Workspace of improveProfile
+    std::vector<usize> row_first; // Smallest label in the closed neighbourhood of each row
+    std::vector<char> improve_mark; // Neighbours of the vertex labeled L + 1
+    /// Stratified sample of rows (offspring screening)
+    std::vector<usize> sample_rows; // One sampled row per stratum
+    std::vector<usize> sample_row_index; // Row pointers of the sampled rows
+    std::vector<usize> sample_col_index; // Column indices of the sampled rows (compact copy)
+    realT sample_scale = 1; // m / number of sampled rows
+    std::vector<usize> wavefront_delta; // Aux vector of evaluateOrdering (wavefront changes per step)
+    OrderingMetrics metrics; // Metrics of the last evaluateOrdering
     // Vertices affected in swaping and updating profile 
     TimePoint t_start; // Start time
     std::chrono::seconds max_time; // Maximum execution time
@@ -30,14 +63,30 @@ public:
     usize max_degree = 0; // Maximum degree of instance
     usize min_degree; // Maximum degree of instance
     bool symmetric;
+    std::shared_ptr<const Graph> graph; // Arrays viewed by col_index, row_index and degree
 
-    // Simple construtor
+    // Simple construtor (without a graph)
     CSR(usize rows, usize nnz);
     // Constructor overloaded for reading .mtx files
     CSR(const std::string& path, bool f_symmetric = false);
+    // Set the graph (shared by the copies from now on)
+    void setGraph(Graph g);
 
     // Evaluate profile
     void evaluateProfile();
+    // Evaluate the metrics of labels selected by METRICS (bit mask of METRIC_*) in a single pass
+    template <unsigned METRICS>
+    void evaluateOrdering();
+    // Evaluate the objective function of labels (computes only the metrics it needs)
+    template <Objective OBJ>
+    unsigned long evaluateObjective() {
+        evaluateOrdering<objectiveMetrics(OBJ)>();
+        return metrics.value(OBJ);
+    }
+    // Draw a stratified sample of rows (one row per stratum) for estimateProfile
+    void sampleRows(const usize SIZE);
+    // Estimate the profile of labels from the sampled rows
+    unsigned long estimateProfile() const;
 
     /// Pseudoperipheral vertex
     // Get a pair of pseudoperipheral (s, e) (Sloan's algorithm)
@@ -56,6 +105,10 @@ public:
     void enhancedSloanMGPSPriority2(const std::vector<realT>& priority = {});
     // This method uses the priority function (4) of the enhanced Sloan from Reid and Scott (1999) and (2.5) of Hu and Scoot (2001)
     void enhancedSloanMGPS();
+    // Swaps of consecutive labels that reduce the profile, for at most TIME_CAP (returns the reduction)
+    // inverse must be the inverse of labels (it is kept up to date). *stopped (if given) tells whether
+    // TIME_CAP ended it before a local optimum
+    unsigned long improveProfile(const std::chrono::nanoseconds TIME_CAP, bool* stopped = nullptr);
 
     /// Constructive methods
     // Randomized semi-greed constructive method based on SloanMGPS
@@ -73,6 +126,8 @@ public:
     CSR getCoarseGraph(const std::vector<usize>& mis);
     // SloanMGPS (MC60) with global priority function
     void sloanMGPSPriority(const realT w1 = 2, const realT w2 = 1, const std::vector<realT>& priority = {});
+    // SloanMGPS with global priority function from the given pseudoperipheral pair (s, e)
+    void sloanMGPSPriority(const realT w1, const realT w2, const std::vector<realT>& priority, const std::pair<usize, usize> pp);
 
     /// Misc
     // Get vertices from the last level structure and eccentricity
@@ -83,9 +138,14 @@ public:
     usize getDiameter();
     // Recursive Breadth-First Search (DFS) 
     void bfs(usize v);
+    // Lower bounds of the ordering metrics (bandwidth uses level structures of ROOTS vertices)
+    OrderingMetrics lowerBounds(const usize ROOTS = 16) const;
     // Verify if solution is viable (LABELS only)
     bool isFeasible() const;
 };
 
+// Verify if labels is a permutation of [0, m) (bitmap, in parallel for large m)
+bool isPermutation(const std::vector<usize>& labels, const usize m);
+
 // https://math.nist.gov/MatrixMarket/formats.html
 #endif
\ No newline at end of file
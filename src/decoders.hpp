@@ -0,0 +1,72 @@
+#ifndef DECODERS_H
+#define DECODERS_H
+
+#include "random_keys.hpp"
+
+/// Decoding policies (template parameter of the BRKGA-Pr, selected by Decoder)
+// decode(csr, fingerprint): random_keys -> labels (with the fingerprint of the labels if not null)
+// encode(csr): labels -> random_keys, then labels is the decoding of the keys
+// prepare(csr): state of the decoder shared by all decodings of the graph (before csr is copied)
+// SORTED: the labels are the keys sorted, so offspring can be decoded by deltaDecoder and
+//         improved labels can be written back into the keys by encoderSorted (Lamarckian improvement)
+
+// Keys sorted into labels
+struct SortDecoder {
+    static constexpr bool SORTED = true;
+
+    static void decode(CSR& csr, Fingerprint* fingerprint = nullptr) {
+        decoder(csr, fingerprint);
+    }
+    static void encode(CSR& csr) {
+        encoder(csr);
+    }
+    static void prepare(CSR&) {}
+};
+
+// Keys as vertex priorities within level structures
+struct LevelDecoder {
+    static constexpr bool SORTED = false;
+
+    static void decode(CSR& csr, Fingerprint* fingerprint = nullptr) {
+        levelDecoder(csr, fingerprint);
+    }
+    static void encode(CSR& csr) {
+        priorityEncoder(csr);
+        levelDecoder(csr);
+    }
+    static void prepare(CSR&) {}
+};
+
+// Keys as the global priorities of Sloan-MGPS
+struct SloanDecoder {
+    static constexpr bool SORTED = false;
+
+    static void decode(CSR& csr, Fingerprint* fingerprint = nullptr) {
+        sloanDecoder(csr, fingerprint);
+    }
+    static void encode(CSR& csr) {
+        priorityEncoder(csr);
+        sloanDecoder(csr);
+    }
+    // The pseudoperipheral pair is randomized: copies of csr must decode with the same one
+    static void prepare(CSR& csr) {
+        sloanDecoderPP(csr);
+    }
+};
+
+// prepare of the decoder selected at run time (before csr is copied into other processes)
+inline void prepareDecoder(CSR& csr, const Decoder decoder) {
+    switch (decoder) {
+        case Decoder::Sort:
+            SortDecoder::prepare(csr);
+            break;
+        case Decoder::Level:
+            LevelDecoder::prepare(csr);
+            break;
+        case Decoder::Sloan:
+            SloanDecoder::prepare(csr);
+            break;
+    }
+}
+
+#endif
\ No newline at end of file
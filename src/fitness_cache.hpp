@@ -0,0 +1,90 @@
+#ifndef FITNESS_CACHE_H
+#define FITNESS_CACHE_H
+
+#include "types.hpp"
+#include <atomic>
+#include <memory>
+
+// Bounded lock-free map from the fingerprint of a labeling to its objective value
+// Open addressing with at most MAX_PROBE probes; entries are never overwritten nor erased
+// (when the probes are all taken the insertion is dropped)
+class FitnessCache {
+public:
+    // 2^LOG2_SLOTS slots (0 disables the cache)
+    explicit FitnessCache(const usize LOG2_SLOTS)
+        : n_slots(LOG2_SLOTS == 0 ? 0 : 1u << LOG2_SLOTS), slots(new Slot[n_slots]) {}
+
+    bool enabled() const {
+        return n_slots > 0;
+    }
+
+    // Get the value of f (false if it is not in the cache)
+    bool find(const Fingerprint& f, unsigned long& value) {
+        const uint64_t key = tagOf(f);
+        for (usize p = 0, idx = first(f); p < MAX_PROBE; ++p, idx = (idx + 1) & (n_slots - 1)) {
+            const uint64_t tag = slots[idx].tag.load(std::memory_order_acquire);
+            if (tag == EMPTY)
+                break;
+            // hi and value are published before the tag (release)
+            if (tag == key && slots[idx].hi == f.hi) {
+                value = slots[idx].value;
+                hits.fetch_add(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Insert the value of f
+    void insert(const Fingerprint& f, const unsigned long value) {
+        const uint64_t key = tagOf(f);
+        for (usize p = 0, idx = first(f); p < MAX_PROBE; ++p, idx = (idx + 1) & (n_slots - 1)) {
+            uint64_t tag = slots[idx].tag.load(std::memory_order_acquire);
+            if (tag == key && slots[idx].hi == f.hi)
+                return;
+            // Claim an empty slot, fill it and publish the key
+            if (tag == EMPTY && slots[idx].tag.compare_exchange_strong(tag, BUSY, std::memory_order_acquire)) {
+                slots[idx].hi = f.hi;
+                slots[idx].value = value;
+                slots[idx].tag.store(key, std::memory_order_release);
+                return;
+            }
+        }
+        dropped.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Memory used by the slots (bytes)
+    unsigned long bytes() const {
+        return static_cast<unsigned long>(n_slots) * sizeof(Slot);
+    }
+
+    std::atomic<unsigned long> hits{0};
+    std::atomic<unsigned long> misses{0};
+    std::atomic<unsigned long> dropped{0}; // Insertions without a free slot
+
+private:
+    static constexpr usize MAX_PROBE = 8;
+    static constexpr uint64_t EMPTY = 0;
+    static constexpr uint64_t BUSY = 1;
+
+    struct Slot {
+        std::atomic<uint64_t> tag{EMPTY}; // EMPTY, BUSY or the low lane of the fingerprint
+        uint64_t hi = 0; // High lane of the fingerprint
+        unsigned long value = 0;
+    };
+
+    // The low lane is the tag (EMPTY and BUSY are remapped)
+    static uint64_t tagOf(const Fingerprint& f) {
+        return f.lo > BUSY ? f.lo : f.lo + 2;
+    }
+
+    usize first(const Fingerprint& f) const {
+        return static_cast<usize>(f.hi) & (n_slots - 1);
+    }
+
+    const usize n_slots;
+    std::unique_ptr<Slot[]> slots;
+};
+
+#endif
\ No newline at end of file
@@ -124,17 +124,26 @@ void CSR::sloanMGPS(realT w1, realT w2, const bool normalized) {
 // SloanMGPS (MC60) with global priority function (4) of the hibryd Sloan 
 // from Reid and Scott (1999) and (2.5) of Hu and Scoot (2001)
 void CSR::sloanMGPSPriority(const realT w1, const realT w2, const std::vector<realT>& priority) {
-    // Data of vertices
-    std::vector<VertexDataReal> vertices(m);
-    /// Priority queue (vertices active or preactive)
-    std::vector<VertexCostReal> Q;
-    robin_hood::unordered_map<usize, usize> idx_Q;
+    /// Step 1 and 2 - Pseudo-peripheral nodes s and e
+    sloanMGPSPriority(w1, w2, priority, mgpsPP());
+}
+
+// SloanMGPS (MC60) with global priority function from the pseudo-peripheral nodes pp = (s, e)
+void CSR::sloanMGPSPriority(const realT w1, const realT w2, const std::vector<realT>& priority, const std::pair<usize, usize> pp) {
+    // Data of vertices (workspace kept between calls, see sloan_vertices)
+    std::vector<VertexDataReal>& vertices = sloan_vertices;
+    vertices.resize(m);
+    /// Priority queue (vertices active or preactive), empty after every labeling
+    std::vector<VertexCostReal>& Q = sloan_queue;
+    robin_hood::unordered_map<usize, usize>& idx_Q = sloan_idx;
+    Q.clear();
+    if (!idx_Q.empty())
+        idx_Q.clear();
     // Misc
     usize current_label = 0;
     realT max_real = std::numeric_limits<realT>::max();
 
-    /// Step 1 and 2 - Pseudo-peripheral nodes s and e
-    auto [s, e] = mgpsPP();
+    const auto [s, e] = pp;
 
     // Compute distances from e (in vector *distance*)
     bfs(e);
@@ -352,7 +361,7 @@ void CSR::mpg() {
 
 
     /// (3) (Initialize current degrees d, priorities and numbers of connections to q
-    d = degree;
+    d.assign(degree.begin(), degree.end());
     for (usize i = 0; i < m; ++i)
         p[i] = d_e[i] - 2 * d[i];
     a.assign(m, 0);
@@ -474,3 +483,102 @@ void CSR::mpg() {
         }
     } while (current_label < m);
 }
+
+// Local improvement of labels by swaps of consecutive labels (L, L + 1) that reduce the profile
+// A swap changes the rows of the two vertices and the rows whose smallest label is L (neighbours of
+// the vertex labeled L only) or L + 1 (neighbours of the vertex labeled L + 1 only), so it is evaluated
+// in O(degree) from the smallest label of every row
+// Passes over the labels until no swap improves or TIME_CAP is reached (checked every 256 swaps)
+// Sets profile and returns the reduction; the scratch vectors are members (no allocation after the first call)
+// The vertex of each label is read from (and kept in) inverse
+unsigned long CSR::improveProfile(const std::chrono::nanoseconds TIME_CAP, bool* stopped) {
+    const auto deadline = std::chrono::steady_clock::now() + TIME_CAP;
+    row_first.resize(m);
+    improve_mark.assign(m, false);
+
+    // Smallest label in the closed neighbourhood of v
+    const auto first = [this](const usize v) {
+        usize f = labels[v];
+        for (usize j_idx = row_index[v]; j_idx < row_index[v + 1]; ++j_idx)
+            f = std::min(f, labels[col_index[j_idx]]);
+        return f;
+    };
+
+    unsigned long total = 0;
+    for (usize i = 0; i < m; ++i) {
+        row_first[i] = first(i);
+        total += labels[i] - row_first[i];
+    }
+    const unsigned long initial = total;
+
+    bool improved = true;
+    bool timeout = false;
+    usize attempts = 0;
+    while (improved && !timeout) {
+        improved = false;
+        for (usize L = 0; L + 1 < m; ++L) {
+            if ((++attempts & 255) == 0 && std::chrono::steady_clock::now() > deadline) {
+                timeout = true;
+                break;
+            }
+            const usize a = inverse[L];
+            const usize b = inverse[L + 1];
+            long delta = 0;
+
+            // Rows adjacent to a only lose L (their width decreases if it was the smallest label)
+            for (usize j_idx = row_index[b]; j_idx < row_index[b + 1]; ++j_idx)
+                improve_mark[col_index[j_idx]] = true;
+            for (usize j_idx = row_index[a]; j_idx < row_index[a + 1]; ++j_idx) {
+                const usize j = col_index[j_idx];
+                if (j != b && !improve_mark[j] && row_first[j] == L)
+                    --delta;
+            }
+            // Rows adjacent to b only gain L (smallest label L + 1 implies not adjacent to a)
+            for (usize j_idx = row_index[b]; j_idx < row_index[b + 1]; ++j_idx) {
+                const usize j = col_index[j_idx];
+                if (j != a && row_first[j] == L + 1)
+                    ++delta;
+            }
+
+            // Rows a and b
+            labels[a] = L + 1;
+            labels[b] = L;
+            const usize first_a = first(a);
+            const usize first_b = first(b);
+            delta += static_cast<long>(L + 1 - first_a) - static_cast<long>(L - row_first[a]);
+            delta += static_cast<long>(L - first_b) - static_cast<long>(L + 1 - row_first[b]);
+
+            if (delta < 0) {
+                for (usize j_idx = row_index[a]; j_idx < row_index[a + 1]; ++j_idx) {
+                    const usize j = col_index[j_idx];
+                    if (j != b && !improve_mark[j] && row_first[j] == L)
+                        row_first[j] = L + 1;
+                }
+                for (usize j_idx = row_index[b]; j_idx < row_index[b + 1]; ++j_idx) {
+                    const usize j = col_index[j_idx];
+                    if (j != a && row_first[j] == L + 1)
+                        row_first[j] = L;
+                }
+                row_first[a] = first_a;
+                row_first[b] = first_b;
+                inverse[L] = b;
+                inverse[L + 1] = a;
+                total += delta;
+                improved = true;
+            } else {
+                labels[a] = L;
+                labels[b] = L + 1;
+            }
+
+            for (usize j_idx = row_index[b]; j_idx < row_index[b + 1]; ++j_idx)
+                improve_mark[col_index[j_idx]] = false;
+        }
+    }
+
+    if (stopped)
+        *stopped = timeout;
+    profile = total;
+    if (profile < best_profile)
+        best_profile = profile;
+    return initial - total;
+}
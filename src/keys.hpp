@@ -0,0 +1,156 @@
+#ifndef KEYS_H
+#define KEYS_H
+
+#include "types.hpp"
+#include "misc.hpp"
+#include "radix_sort.hpp"
+#include "rng.hpp"
+
+/// Random-key pipeline templated on the key type Key (double, float or uint32_t)
+/// The chromosomes of a build use rkT (make KEYS=float|u32)
+
+// Below RADIX_MIN keys the decoder uses std::sort
+constexpr usize RADIX_MIN = 256;
+
+// From PARALLEL_RK_MIN keys the decoder and the encoder run in parallel (num_threads)
+constexpr usize PARALLEL_RK_MIN = 1 << 20;
+
+// The encoder generates the keys in blocks of RK_BLOCK, each from its own stream
+constexpr usize RK_BLOCK = 1 << 16;
+
+inline bool parallelRK(const usize n) {
+    return n >= PARALLEL_RK_MIN && num_threads > 1;
+}
+
+// Unsigned integer with the order of a key
+// The real keys are non-negative, so the order of their IEEE-754 bit patterns is the order of the values
+inline uint64_t keyBits(const double key) {
+    return std::bit_cast<uint64_t>(key);
+}
+inline uint32_t keyBits(const float key) {
+    return std::bit_cast<uint32_t>(key);
+}
+inline uint32_t keyBits(const uint32_t key) {
+    return key;
+}
+
+// Key as a real number in [0, 1)
+inline realT keyReal(const double key) {
+    return key;
+}
+inline realT keyReal(const float key) {
+    return key;
+}
+inline realT keyReal(const uint32_t key) {
+    return static_cast<realT>(key) * 0x1.0p-32;
+}
+
+// Sort keys with their indices by key, ties broken by the index (tmp: scratch, may be swapped with a)
+// LSD radix sort (stable), parallelRadixSort for large chromosomes (parallelRK), std::sort below RADIX_MIN
+template <typename Key>
+void sortByKey(std::vector<IndexedKey<Key>>& a, std::vector<IndexedKey<Key>>& tmp) {
+    const usize n = a.size();
+    if (n < RADIX_MIN) {
+        std::sort(a.begin(), a.end(), [](const IndexedKey<Key>& x, const IndexedKey<Key>& y) {
+            return x.value < y.value || (x.value == y.value && x.index < y.index);
+        });
+        return;
+    }
+
+    const auto key = [](const IndexedKey<Key>& e) {
+        return keyBits(e.value);
+    };
+    if (parallelRK(n))
+        parallelRadixSort(a, tmp, key);
+    else
+        radixSort(a, tmp, key);
+}
+
+// Run fn(b, begin, end) for each block b = [begin, end) of RK_BLOCK keys of [0, n)
+template <typename F>
+void forEachBlock(const usize n, F&& fn) {
+    const usize n_blocks = (n + RK_BLOCK - 1) / RK_BLOCK;
+
+    parallelFor(n_blocks, parallelRK(n) ? 1 : n_blocks, [&](usize, const usize b0, const usize b1) {
+        for (usize b = b0; b < b1; ++b)
+            fn(b, b * RK_BLOCK, std::min(n, (b + 1) * RK_BLOCK));
+    });
+}
+
+// Run fn(rng, b, begin, end) for each block of keys (see forEachBlock), rng being the stream of the block
+// One seed is drawn from the global generator per call, so the keys depend only on it (not on num_threads)
+template <typename F>
+void forEachKeyBlock(const usize n, F&& fn) {
+    const uint64_t seed = getRNG()();
+
+    forEachBlock(n, [&](const usize b, const usize begin, const usize end) {
+        Xoshiro256 rng = streamRNG(seed, b);
+        fn(rng, b, begin, end);
+    });
+}
+
+// Exponential random variable of mean 1 (strictly positive: the uniform is drawn in (0, 1))
+inline realT exponential(Xoshiro256& rng) {
+    return -std::log((static_cast<realT>(rng() >> 12) + 0.5) * 0x1.0p-52);
+}
+
+// n strictly increasing keys in O(n): assign(i, key) for the i-th smallest key (tmp: scratch of n keys)
+// Integer keys are rank-quantized: the i-th key is drawn in its own stride [i * q, (i + 1) * q), q = floor(2^32 / n)
+// (multiples of 2^-32; crossover only copies keys, so the loss shows up as ties between keys of different
+// parents, about n^2 / 2^32 per offspring at most, broken by the index in the decoder)
+// Real keys are normalized exponential spacings: with E_1, ..., E_{n+1} i.i.d. Exp(1) and
+// S_k = E_1 + ... + E_k, (S_1, ..., S_n) / S_{n+1} is distributed as n sorted U(0, 1)
+// The sums are in realT and the keys rounded to Key; a key rounded onto its predecessor (float) is moved to
+// the next representable value, so the keys are strictly increasing and the encoding round-trips
+template <typename Key, typename F>
+void sortedKeys(const usize n, std::vector<Key>& tmp, F&& assign) {
+    if constexpr (std::is_integral_v<Key>) {
+        static_assert(sizeof(Key) == 4, "sortedKeys: integer keys must have 32 bits");
+        const uint64_t q = (uint64_t(1) << 32) / n;
+
+        forEachKeyBlock(n, [&](Xoshiro256& rng, usize, const usize begin, const usize end) {
+            for (usize i = begin; i < end; ++i)
+                assign(i, static_cast<Key>(i * q + (rng() >> 32) * q / (uint64_t(1) << 32)));
+        });
+    } else {
+        const usize n_blocks = (n + RK_BLOCK - 1) / RK_BLOCK;
+        std::vector<realT> offset(n_blocks + 1);
+
+        // Spacings and their sum per block (the last block also draws E_{n+1})
+        forEachKeyBlock(n, [&](Xoshiro256& rng, const usize b, const usize begin, const usize end) {
+            realT sum = 0;
+            for (usize i = begin; i < end; ++i) {
+                tmp[i] = static_cast<Key>(exponential(rng));
+                sum += tmp[i];
+            }
+            if (end == n)
+                sum += exponential(rng);
+            offset[b + 1] = sum;
+        });
+        for (usize b = 0; b < n_blocks; ++b)
+            offset[b + 1] += offset[b];
+
+        // Normalized prefix sums
+        const realT inv_total = 1 / offset[n_blocks];
+        forEachBlock(n, [&](const usize b, const usize begin, const usize end) {
+            realT sum = offset[b];
+            for (usize i = begin; i < end; ++i) {
+                sum += tmp[i];
+                tmp[i] = static_cast<Key>(sum * inv_total);
+            }
+        });
+
+        // Strictly increasing
+        for (usize i = 1; i < n; ++i) {
+            if (!(tmp[i] > tmp[i - 1]))
+                tmp[i] = std::nextafter(tmp[i - 1], std::numeric_limits<Key>::infinity());
+        }
+
+        forEachBlock(n, [&](usize, const usize begin, const usize end) {
+            for (usize i = begin; i < end; ++i)
+                assign(i, tmp[i]);
+        });
+    }
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "csr.hpp"
+#include "parallel.hpp"
+
+// Lower bounds of the ordering metrics (same fields of OrderingMetrics)
+// Profile, envelope and wavefronts are bounded per connected component: restricting an ordering
+// to a component never widens its rows nor its wavefronts.
+//  - Each lower neighbour of a row is in a distinct column: profile >= |E|
+//  - After numbering s vertices (S), the rows of the remaining vertices adjacent to S are active.
+//    With minimum degree d, at least max(1, d - s + 1) of them, and all the n - s remaining ones when n - s <= d
+//  - The wavefronts add up to profile + n: max >= average and (Cauchy-Schwarz) sum of squares >= (profile + n)^2 / n
+// Bandwidth uses the level structures rooted at the ROOTS highest-degree vertices:
+// the |N_k(r)| vertices within distance k of r are labeled within k * bandwidth of r
+OrderingMetrics CSR::lowerBounds(const usize ROOTS) const {
+    const usize max_usize = std::numeric_limits<usize>::max();
+    OrderingMetrics lb;
+    lb.m = m;
+
+    /// Connected components (BFS)
+    std::vector<usize> component(m, max_usize);
+    std::vector<usize> queue(m);
+    for (usize r = 0; r < m; ++r) {
+        if (component[r] != max_usize) continue;
+
+        usize head = 0, tail = 0;
+        unsigned long sum_degree = 0;
+        usize min_d = max_usize;
+        queue[tail++] = r;
+        component[r] = r;
+        while (head < tail) {
+            const usize u = queue[head++];
+            sum_degree += degree[u];
+            min_d = std::min(min_d, degree[u]);
+            for (usize j_idx = row_index[u]; j_idx < row_index[u + 1]; ++j_idx) {
+                const usize w = col_index[j_idx];
+                if (component[w] == max_usize) {
+                    component[w] = r;
+                    queue[tail++] = w;
+                }
+            }
+        }
+
+        /// Bounds of the component with n vertices
+        const usize n = tail;
+        unsigned long boundary = 0;
+        for (usize s = 1; s < n; ++s) {
+            const usize t = n - s;
+            usize b = 1;
+            if (min_d + 1 > s)
+                b = std::max(b, min_d + 1 - s);
+            if (t <= min_d)
+                b = std::max(b, t);
+            boundary += b;
+        }
+        const unsigned long profile_c = std::max(sum_degree / 2, boundary);
+        const realT wavefronts = static_cast<realT>(profile_c + n);
+
+        lb.profile += profile_c;
+        lb.envelope += profile_c + n;
+        lb.max_wavefront = std::max({lb.max_wavefront, n > 1 ? min_d + 1 : 1u,
+                                     static_cast<usize>((profile_c + n + n - 1) / n)});
+        // Rounded down with a margin against the floating point error
+        lb.sum_sq_wavefront += static_cast<unsigned long>(std::floor(wavefronts * (wavefronts / n) * (1 - 1e-12)));
+    }
+
+    /// Bandwidth: level structures of the highest-degree vertices (in parallel)
+    std::vector<usize> roots(m);
+    std::iota(roots.begin(), roots.end(), 0);
+    const usize n_roots = std::min(ROOTS, m);
+    std::partial_sort(roots.begin(), roots.begin() + n_roots, roots.end(), [this](const usize a, const usize b) {
+        return degree[a] > degree[b];
+    });
+    roots.resize(n_roots);
+
+    // One task per root (BFS of very different costs, see parallelTasks), buffers per worker
+    std::vector<usize> root_bound(n_roots, 0);
+    std::vector<std::vector<char>> seen_of(numWorkers(n_roots));
+    std::vector<std::vector<usize>> level_of(seen_of.size());
+    parallelTasks(n_roots, [&](const usize worker, const usize idx) {
+        std::vector<char>& seen = seen_of[worker];
+        std::vector<usize>& level = level_of[worker];
+        if (seen.empty()) {
+            seen.assign(m, false);
+            level.resize(m);
+        }
+        const usize r = roots[idx];
+        usize head = 0, tail = 0, k = 0;
+        level[tail++] = r;
+        seen[r] = true;
+        while (head < tail) {
+            // Expand level k into k + 1
+            const usize level_end = tail;
+            while (head < level_end) {
+                const usize u = level[head++];
+                for (usize j_idx = row_index[u]; j_idx < row_index[u + 1]; ++j_idx) {
+                    const usize w = col_index[j_idx];
+                    if (!seen[w]) {
+                        seen[w] = true;
+                        level[tail++] = w;
+                    }
+                }
+            }
+            ++k;
+            // Ball of radius k has tail vertices
+            if (tail > level_end)
+                root_bound[idx] = std::max(root_bound[idx], (tail - 1 + 2 * k - 1) / (2 * k));
+        }
+        // Reset only the visited vertices
+        for (usize i = 0; i < tail; ++i)
+            seen[level[i]] = false;
+    });
+
+    lb.bandwidth = (max_degree + 1) / 2;
+    for (const usize b : root_bound)
+        lb.bandwidth = std::max(lb.bandwidth, b);
+
+    return lb;
+}
\ No newline at end of file
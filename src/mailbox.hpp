@@ -0,0 +1,37 @@
+#ifndef MAILBOX_H
+#define MAILBOX_H
+
+#include <atomic>
+#include <memory>
+
+// Lock-free mailbox holding the latest message posted (single slot, any number of senders and one receiver)
+// A message not taken before the next post is discarded, so neither the senders nor the receiver wait
+template <typename T>
+class Mailbox {
+public:
+    Mailbox() = default;
+    Mailbox(const Mailbox&) = delete;
+    Mailbox& operator=(const Mailbox&) = delete;
+    ~Mailbox() {
+        delete slot.load(std::memory_order_acquire);
+    }
+
+    // Post message (replacing the one not taken yet, if any)
+    void post(std::unique_ptr<T> message) {
+        std::unique_ptr<T> old(slot.exchange(message.release(), std::memory_order_acq_rel));
+        if (old)
+            discarded.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    // Take the latest message (null if there is none)
+    std::unique_ptr<T> take() {
+        return std::unique_ptr<T>(slot.exchange(nullptr, std::memory_order_acq_rel));
+    }
+
+    std::atomic<unsigned long> discarded{0}; // Messages replaced before being taken
+
+private:
+    std::atomic<T*> slot{nullptr};
+};
+
+#endif /* MAILBOX_H */
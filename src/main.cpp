@@ -5,26 +5,103 @@
 
 void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &params);
 
+// Objective function from its command-line name
+Objective parseObjective(const std::string& name) {
+    if (name == "profile") return Objective::Profile;
+    if (name == "bandwidth") return Objective::Bandwidth;
+    if (name == "max_wavefront") return Objective::MaxWavefront;
+    if (name == "rms_wavefront") return Objective::RmsWavefront;
+    if (name == "envelope") return Objective::Envelope;
+
+    std::cerr << "\nUnknown objective: " << name << " (profile, bandwidth, max_wavefront, rms_wavefront or envelope)\n";
+    exit(EXIT_FAILURE);
+}
+
+// Migration topology of the islands from its command-line name
+Topology parseTopology(const std::string& name) {
+    if (name == "ring") return Topology::Ring;
+    if (name == "random") return Topology::Random;
+
+    std::cerr << "\nUnknown topology: " << name << " (ring or random)\n";
+    exit(EXIT_FAILURE);
+}
+
+// Decoder from its command-line name
+Decoder parseDecoder(const std::string& name) {
+    if (name == "sort") return Decoder::Sort;
+    if (name == "level") return Decoder::Level;
+    if (name == "sloan") return Decoder::Sloan;
+
+    std::cerr << "\nUnknown decoder: " << name << " (sort, level or sloan)\n";
+    exit(EXIT_FAILURE);
+}
+
 void brkgaEx(CSR& csr, std::map<std::string, ParamValue> &params) {
     if (get<int>(params["pop"]) < 10) {
         std::cerr << "\nYou need to use pop > 10;\n";
         exit(EXIT_FAILURE);
     }
 
+    const int cache = get<int>(params["cache"]);
+    if (cache != 0 && (cache < 8 || cache > 28)) {
+        std::cerr << "\nYou need to use cache = 0 or 8 <= cache <= 28;\n";
+        exit(EXIT_FAILURE);
+    }
+
+    // The islands and the producers of each population are threads of --threads
+    const int threads_needed = std::max(1, get<int>(params["islands"])) * (1 + std::max(0, get<int>(params["producers"])));
+    if (threads_needed > static_cast<int>(num_threads)) {
+        std::cerr << "\nYou need to use threads >= islands * (producers + 1) = " << threads_needed << ";\n";
+        exit(EXIT_FAILURE);
+    }
+
     if (!get<int>(params["irace"]))
         std::cout << "\tBRKGA-Pr... \n"; 
 
     auto start = std::chrono::steady_clock::now();
 
-    brkga(csr, get<int>(params["pop"]), get<int>(params["elite"]), get<int>(params["mutants"]), get<realT>(params["prob"]), get<int>(params["init"]));
+    BRKGAOptions opt;
+    opt.screen = get<realT>(params["screen"]);
+    opt.screen_slack = get<realT>(params["screen_slack"]);
+    opt.objective = parseObjective(get<std::string>(params["objective"]));
+    opt.decoder = parseDecoder(get<std::string>(params["decoder"]));
+    opt.cache = cache;
+    opt.check = get<int>(params["check"]);
+    opt.gap = get<realT>(params["gap"]);
+    opt.improve = get<realT>(params["improve"]);
+    opt.islands = std::max(1, get<int>(params["islands"]));
+    opt.lean = get<int>(params["lean"]);
+    opt.steady = get<int>(params["steady"]);
+    opt.producers = std::max(0, get<int>(params["producers"]));
+    opt.migration = std::max(1, get<int>(params["migration"]));
+    opt.migrants = std::max(0, get<int>(params["migrants"]));
+    opt.topology = parseTopology(get<std::string>(params["topology"]));
+    opt.processes = std::max(1, get<int>(params["processes"]));
+    opt.runs = std::max(1, get<int>(params["runs"]));
+    opt.verbose = get<int>(params["verbose"]) && !get<int>(params["irace"]);
+
+    brkga(csr, get<int>(params["pop"]), get<int>(params["elite"]), get<int>(params["mutants"]), get<realT>(params["prob"]), get<int>(params["init"]), opt);
 
     auto end = std::chrono::steady_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::seconds>(end - start);
 
+    // All metrics of the returned solution (best of the population) in a single pass
+    // best_profile is the profile of the returned solution (see finishPopulation)
+    csr.evaluateOrdering<METRIC_ALL>();
+
     if (!get<int>(params["irace"])) {
         std::cout << "Profile: " << csr.best_profile;
-    } else {
+        if (opt.verbose) {
+            std::cout << "\nSolution: profile " << csr.metrics.profile
+                      << ", bandwidth " << csr.metrics.bandwidth
+                      << ", max wavefront " << csr.metrics.max_wavefront
+                      << ", RMS wavefront " << csr.metrics.rmsWavefront()
+                      << ", envelope " << csr.metrics.envelope;
+        }
+    } else if (opt.objective == Objective::Profile) {
         std::cout << csr.best_profile;
+    } else {
+        std::cout << csr.metrics.value(opt.objective);
     }
 }
 
@@ -58,16 +135,38 @@ int main(int argc, char *argv[]) {
     // Initialize parameters with default values
     std::map<std::string, ParamValue> params = {
         {"irace", 0},
+        {"cache", 0},
+        {"check", 0},
+        {"decoder", std::string("sort")},
         {"filename", std::string("input/usps_norm_5NN.mtx")},
+        {"gap", 0.0f},
+        {"improve", 0.0f},
         {"init", 1},
+        {"islands", 1},
+        {"lean", 0},
         {"max_time", int64_t(10)},
         {"alpha", 0.0f},
         {"pop", 20},
         {"elite", 8},
+        {"migrants", 2},
+        {"migration", 10},
         {"mutants", 4},
+        {"objective", std::string("profile")},
         {"prob", 0.75f},
+        {"processes", 1},
+        {"producers", 0},
+        {"runs", 1},
+        {"screen", 0.0f},
+        {"screen_slack", 0.05f},
+        {"steady", 0},
+        {"threads", 1},
+        {"topology", std::string("ring")},
+        {"verbose", 0},
     };
     parseArguments(argc, argv, params);
+    // Threads of the BRKGA and of the parallel decoder and encoder (1 = serial, default; 0 = all hardware threads)
+    if (get<int>(params["threads"]) > 0)
+        num_threads = get<int>(params["threads"]);
 
     /// Print parameters
     // if (!get<int>(params["irace"])) {
@@ -102,19 +201,26 @@ void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &p
         {"alpha", required_argument, nullptr, 0},
         {"alpha_sa", required_argument, nullptr, 0},
         {"bl", required_argument, nullptr, 0},
+        {"cache", required_argument, nullptr, 0},
+        {"check", required_argument, nullptr, 0},
         {"cross", required_argument, nullptr, 0},
         {"crot_s", required_argument, nullptr, 0},
+        {"decoder", required_argument, nullptr, 0},
         {"delta", required_argument, nullptr, 0},
         {"delta_s", required_argument, nullptr, 0},
         {"elite", required_argument, nullptr, 0},
         {"exp_out", required_argument, nullptr, 0},
         {"filename", required_argument, nullptr, 0},
+        {"gap", required_argument, nullptr, 0},
         {"hamming_t", required_argument, nullptr, 0},
+        {"improve", required_argument, nullptr, 0},
         {"init", required_argument, nullptr, 0},
         {"irace", required_argument, nullptr, 0},
+        {"islands", required_argument, nullptr, 0},
         {"k_step", required_argument, nullptr, 0},
         {"k_max", required_argument, nullptr, 0},
         {"l_0", required_argument, nullptr, 0},
+        {"lean", required_argument, nullptr, 0},
         {"limit", required_argument, nullptr, 0},
         {"l_size", required_argument, nullptr, 0},
         {"level_d", required_argument, nullptr, 0},
@@ -124,13 +230,18 @@ void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &p
         {"min_zeros", required_argument, nullptr, 0},
         {"mi", required_argument, nullptr, 0},
         {"mp", required_argument, nullptr, 0},
+        {"migrants", required_argument, nullptr, 0},
+        {"migration", required_argument, nullptr, 0},
         {"mutants", required_argument, nullptr, 0},
         {"n_pass", required_argument, nullptr, 0},
+        {"objective", required_argument, nullptr, 0},
         {"per", required_argument, nullptr, 0},
         {"per_it", required_argument, nullptr, 0},
         {"pop", required_argument, nullptr, 0},
         {"pool_s", required_argument, nullptr, 0},
         {"prob", required_argument, nullptr, 0},
+        {"processes", required_argument, nullptr, 0},
+        {"producers", required_argument, nullptr, 0},
         {"prob_mut", required_argument, nullptr, 0},
         {"pr_prop", required_argument, nullptr, 0},
         {"prob_per", required_argument, nullptr, 0},
@@ -139,7 +250,14 @@ void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &p
         {"psi", required_argument, nullptr, 0},
         {"repair", required_argument, nullptr, 0},
         {"r_max", required_argument, nullptr, 0},
+        {"runs", required_argument, nullptr, 0},
+        {"screen", required_argument, nullptr, 0},
+        {"screen_slack", required_argument, nullptr, 0},
+        {"steady", required_argument, nullptr, 0},
         {"t_0", required_argument, nullptr, 0},
+        {"threads", required_argument, nullptr, 0},
+        {"topology", required_argument, nullptr, 0},
+        {"verbose", required_argument, nullptr, 0},
         {"t_f", required_argument, nullptr, 0},
         {nullptr, 0, nullptr, 0} // Terminating entry
     };
@@ -158,10 +276,16 @@ void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &p
                 params["bl"] = std::stoi(optarg);
             } else if (option_name == "alpha_sa") {
                 params["alpha_sa"] = std::stof(optarg);
+            } else if (option_name == "cache") {
+                params["cache"] = std::stoi(optarg);
+            } else if (option_name == "check") {
+                params["check"] = std::stoi(optarg);
             } else if (option_name == "cross") {
                 params["cross"] = std::stoi(optarg);
             } else if (option_name == "crot_s") {
                 params["crot_s"] = std::stoi(optarg);
+            } else if (option_name == "decoder") {
+                params["decoder"] = optarg;
             } else if (option_name == "delta") {
                 params["delta"] = std::stoi(optarg);
             } else if (option_name == "delta_s") {
@@ -172,18 +296,26 @@ void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &p
                 params["exp_out"] = optarg;
             } else if (option_name == "filename") {
                 params["filename"] = optarg;
-            }  else if (option_name == "hamming_t") {
+            } else if (option_name == "gap") {
+                params["gap"] = std::stof(optarg);
+            } else if (option_name == "hamming_t") {
                 params["hamming_t"] = std::stof(optarg);
+            } else if (option_name == "improve") {
+                params["improve"] = std::stof(optarg);
             } else if (option_name == "init") {
                 params["init"] = std::stoi(optarg);
             } else if (option_name == "irace") {
                 params["irace"] = std::stoi(optarg);
+            } else if (option_name == "islands") {
+                params["islands"] = std::stoi(optarg);
             } else if (option_name == "k_step") {
                 params["k_step"] = std::stoi(optarg);
             } else if (option_name == "k_max") {
                 params["k_max"] = std::stoi(optarg);
             } else if (option_name == "l_0") {
                 params["l_0"] = std::stoi(optarg);
+            } else if (option_name == "lean") {
+                params["lean"] = std::stoi(optarg);
             } else if (option_name == "limit") {
                 params["limit"] = std::stoi(optarg);
             } else if (option_name == "level_d") {
@@ -198,10 +330,16 @@ void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &p
                 params["max_time"] = std::stoll(optarg);
             } else if (option_name == "min_zeros") {
                 params["min_zeros"] = std::stoi(optarg);
+            } else if (option_name == "migrants") {
+                params["migrants"] = std::stoi(optarg);
+            } else if (option_name == "migration") {
+                params["migration"] = std::stoi(optarg);
             } else if (option_name == "mutants") {
                 params["mutants"] = std::stoi(optarg);
             } else if (option_name == "n_pass") {
                 params["n_pass"] = std::stoi(optarg);
+            } else if (option_name == "objective") {
+                params["objective"] = optarg;
             } else if (option_name == "per") {
                 params["per"] = std::stoi(optarg);
             } else if (option_name == "per_it") {
@@ -216,6 +354,10 @@ void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &p
                 params["prob_per"] = std::stof(optarg);
             } else if (option_name == "prob") {
                 params["prob"] = std::stof(optarg);
+            } else if (option_name == "processes") {
+                params["processes"] = std::stoi(optarg);
+            } else if (option_name == "producers") {
+                params["producers"] = std::stoi(optarg);
             } else if (option_name == "prob_mut") {
                 params["prob_mut"] = std::stof(optarg);
             } else if (option_name == "prob_nex") {
@@ -228,6 +370,20 @@ void parseArguments(int argc, char *argv[], std::map<std::string, ParamValue> &p
                 params["repair"] = std::stoi(optarg);
             } else if (option_name == "r_max") {
                 params["r_max"] = std::stoi(optarg);
+            } else if (option_name == "runs") {
+                params["runs"] = std::stoi(optarg);
+            } else if (option_name == "screen") {
+                params["screen"] = std::stof(optarg);
+            } else if (option_name == "screen_slack") {
+                params["screen_slack"] = std::stof(optarg);
+            } else if (option_name == "steady") {
+                params["steady"] = std::stoi(optarg);
+            } else if (option_name == "threads") {
+                params["threads"] = std::stoi(optarg);
+            } else if (option_name == "topology") {
+                params["topology"] = optarg;
+            } else if (option_name == "verbose") {
+                params["verbose"] = std::stoi(optarg);
             } else if (option_name == "t_0") {
                 params["t_0"] = std::stof(optarg);
             } else if (option_name == "t_f") {
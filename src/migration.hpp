@@ -0,0 +1,67 @@
+#ifndef MIGRATION_H
+#define MIGRATION_H
+
+#include "types.hpp"
+#include "misc.hpp"
+#include "mailbox.hpp"
+
+// Exchange of the best individuals between islands (populations of BRKGA-Pr evolving concurrently)
+// Neither sending nor receiving waits on another island. The send and receive of an island must not run
+// concurrently (one writer per outbox of the SharedBoard, see brkgaSteady)
+class Migration {
+public:
+    virtual ~Migration() = default;
+
+    // Number of islands
+    virtual usize islands() const = 0;
+    // Send the best individuals of island (to the destinations of the topology)
+    virtual void send(const usize island, std::vector<SolutionRK> migrants) = 0;
+    // Latest migrants for island (empty if there are none), the receiver decodes those without labels
+    virtual std::vector<SolutionRK> receive(const usize island) = 0;
+    // Stop every island (one of them reached the gap)
+    virtual void stop() = 0;
+    virtual bool stopped() const = 0;
+};
+
+// Island of the migrants of island (random topology: any other island)
+inline usize migrationPeer(const usize island, const usize n_islands, const Topology topology, const bool next) {
+    if (topology == Topology::Random)
+        return (island + 1 + usizeRandomNumber(0, n_islands - 2)) % n_islands;
+    return next ? (island + 1) % n_islands : (island + n_islands - 1) % n_islands;
+}
+
+// Islands on threads of one process: the migrants are posted to the mailbox of the destination
+class ThreadMigration final : public Migration {
+public:
+    ThreadMigration(const usize n_islands, const Topology topology) : inbox(n_islands), topology(topology) {}
+
+    usize islands() const override {
+        return inbox.size();
+    }
+    void send(const usize island, std::vector<SolutionRK> migrants) override {
+        const usize destination = migrationPeer(island, islands(), topology, true);
+        inbox[destination].post(std::make_unique<std::vector<SolutionRK>>(std::move(migrants)));
+    }
+    std::vector<SolutionRK> receive(const usize island) override {
+        const auto migrants = inbox[island].take();
+        return migrants ? std::move(*migrants) : std::vector<SolutionRK>{};
+    }
+    void stop() override {
+        stop_flag.store(true, std::memory_order_relaxed);
+    }
+    bool stopped() const override {
+        return stop_flag.load(std::memory_order_relaxed);
+    }
+
+    // Migrations replaced in the mailbox of island before being received
+    unsigned long discarded(const usize island) const {
+        return inbox[island].discarded;
+    }
+
+private:
+    std::vector<Mailbox<std::vector<SolutionRK>>> inbox; // Latest migrants sent to each island
+    const Topology topology;
+    std::atomic<bool> stop_flag{false};
+};
+
+#endif /* MIGRATION_H */
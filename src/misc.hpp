@@ -2,48 +2,69 @@
 #define MISC_H
 
 #include "types.hpp"
+#include "rng.hpp"
 #include <functional>
 #include <random>
+#include <atomic>
 
+// Seed of the run
 #ifdef SEED
-  inline std::mt19937 mt(static_cast<std::mt19937::result_type>(SEED));
+  inline const uint64_t run_seed = static_cast<uint64_t>(SEED);
 #else
   inline std::random_device rd;
-  inline std::mt19937 mt(rd());
+  inline const uint64_t run_seed = (static_cast<uint64_t>(rd()) << 32) | rd();
 #endif
-// Static distributions
+// Streams of run_seed taken by the threads (the first thread to draw, usually the main one, gets stream 0)
+inline std::atomic<uint64_t> next_thread_stream{0};
+// Generator of the thread (tasks that must not depend on the scheduling select their own stream, see ScopedRNG)
+inline thread_local Xoshiro256 thread_rng = streamRNG(run_seed, next_thread_stream++);
+// Static distributions (per thread, distRNumber changes its parameters)
 constexpr realT after_one = std::nextafter(1.0, 2.0);
-inline std::uniform_real_distribution<realT> disRK(0.0, 1.0);
-inline std::uniform_int_distribution<usize> distRNumber;
-inline std::uniform_int_distribution<usize> distRLabel;
-inline std::uniform_real_distribution<realT> betweenZeroAndOne(0.0, after_one);
+inline thread_local std::uniform_int_distribution<usize> distRNumber;
+inline thread_local std::uniform_real_distribution<realT> betweenZeroAndOne(0.0, after_one);
 
 ////////        INLINE
-// Get Mersenne Twister generator
-inline std::mt19937& getMT() {
-    return mt;
+// Get the generator of the thread
+inline Xoshiro256& getRNG() {
+    return thread_rng;
 }
 
+// The generator of the thread is `stream` while in scope (restored on exit)
+// A task drawing from its own stream gives the same result on any thread
+class ScopedRNG {
+public:
+    explicit ScopedRNG(const Xoshiro256& stream) : saved(getRNG()) {
+        getRNG() = stream;
+    }
+    ~ScopedRNG() {
+        getRNG() = saved;
+    }
+    ScopedRNG(const ScopedRNG&) = delete;
+    ScopedRNG& operator=(const ScopedRNG&) = delete;
+
+private:
+    const Xoshiro256 saved;
+};
+
 // Generating an USIZE random number between min and max (inclusive)
 inline usize usizeRandomNumber(const usize min, const usize max) {
     distRNumber.param(typename decltype(distRNumber)::param_type(min, max));
-    return distRNumber(getMT());
+    return distRNumber(getRNG());
 }
 
-// Generating an USIZE random number between [0, max] (inclusive)
-// Do not work if multiple graphs are instantiated
-inline usize usizeRandomLabel() {
-    return distRLabel(getMT());
+// Generating an USIZE random label of a graph with m vertices, in [0, m)
+inline usize usizeRandomLabel(const usize m) {
+    return usizeRandomNumber(0, m - 1);
 }
 
 // Generating an REAL random number between [0, 1)
 inline realT realRK() {
-    return disRK(getMT());
+    return getRNG().real();
 }
 
 // Generating an REAL random number between [0, 1] *Inclusive*
 inline realT realZeroOneInclusive() {
-    return betweenZeroAndOne(getMT());
+    return betweenZeroAndOne(getRNG());
 }
 
 #endif
\ No newline at end of file
@@ -129,24 +129,27 @@ CSR CSR::getCoarseGraph(const std::vector<usize>& mis) {
     /// Building the CSR for the coarse graph
     // First, compute row_index for coarse graph
     CSR coarse_csr = CSR(coarse_m, nnz);
-    coarse_csr.row_index.resize(coarse_m + 1);
+    Graph g;
+    g.row_index.resize(coarse_m + 1);
+    g.col_index.reserve(nnz);
     coarse_csr.labels.resize(coarse_m);
     iota(coarse_csr.labels.begin(), coarse_csr.labels.end(), 0);
-    coarse_csr.degree.resize(coarse_m);
+    g.degree.resize(coarse_m);
     coarse_csr.min_degree = max_usize;
     coarse_csr.max_degree = 0;
 
     for (usize i = 0; i < coarse_m; ++i) {
         const usize n_size = coarse_neighbors[i].size();
-        coarse_csr.degree[i] = n_size;
+        g.degree[i] = n_size;
         coarse_csr.min_degree = std::min(coarse_csr.min_degree, n_size);
         coarse_csr.max_degree = std::max(coarse_csr.max_degree, n_size);
 
-        coarse_csr.row_index[i + 1] = coarse_csr.row_index[i] + n_size;
+        g.row_index[i + 1] = g.row_index[i] + n_size;
         std::vector<int> vec(coarse_neighbors[i].begin(), coarse_neighbors[i].end());
         std::sort(vec.begin(), vec.end());
-        coarse_csr.col_index.insert(coarse_csr.col_index.end(), vec.begin(), vec.end());
+        g.col_index.insert(g.col_index.end(), vec.begin(), vec.end());
     }
+    coarse_csr.setGraph(std::move(g));
 
     return coarse_csr;
 }
@@ -241,7 +244,7 @@ void CSR::msW(const std::vector<realT>& priority, const usize ALGO_BASE) {
 
     /// The W additional re-coarsening of the refined graph
     // No need to re-compute MIS (it's the same)
-    static std::vector<realT> pri(m); // Initialize with the correct size
+    thread_local std::vector<realT> pri(m); // Initialize with the correct size
     std::transform(labels.begin(), labels.end(), pri.begin(), [](usize val) { return static_cast<realT>(val); });
     
     ++level;
@@ -300,7 +303,7 @@ void CSR::msWConstrutiveSM(const std::vector<realT>& priority) {
 
     /// The W additional re-coarsening of the refined graph
     // No need to re-compute MIS (it's the same)
-    static std::vector<realT> pri(m); // Initialize with the correct size
+    thread_local std::vector<realT> pri(m); // Initialize with the correct size
     std::transform(labels.begin(), labels.end(), pri.begin(), [](usize val) { return static_cast<realT>(val); });
     
     ++level;
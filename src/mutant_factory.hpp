@@ -0,0 +1,143 @@
+#ifndef MUTANT_FACTORY_H
+#define MUTANT_FACTORY_H
+
+#include "population.hpp"
+#include "parallel.hpp"
+#include "misc.hpp"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Bounded queue of ready-made mutants filled by background producer threads, each one on its own copy of
+// csr (a workspace on the shared graph, see CSR). BUILD(ws) builds a mutant in ws (keys and labels)
+// and returns its objective value
+// Mutant k is built from the random stream k of the seed and mutants are popped in order, so the sequence
+// of mutants does not depend on the producers. The depth of the queue (mutants built ahead) grows when a
+// pop waits and shrinks when the producers find it full, between min_depth and max_depth
+template <typename BUILD>
+class MutantFactory {
+public:
+    MutantFactory(const CSR& csr, const usize producers, const usize min_depth, const usize max_depth, const uint64_t seed, BUILD build)
+        : build(std::move(build)), seed(seed), min_depth(std::max<usize>(min_depth, 1)), max_depth(std::max(max_depth, this->min_depth)),
+          depth(this->min_depth), buffers(this->max_depth), workspaces(producers, csr) {
+        threads.reserve(producers);
+        for (usize p = 0; p < producers; ++p)
+            threads.emplace_back(&MutantFactory::produce, this, p);
+    }
+    MutantFactory(const MutantFactory&) = delete;
+    MutantFactory& operator=(const MutantFactory&) = delete;
+    // Stop the producers (a mutant under construction is finished first)
+    ~MutantFactory() {
+        {
+            const std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        space.notify_all();
+        for (auto& t : threads)
+            t.join();
+    }
+
+    // Store the next mutant in slot of arena (waits until it is built) and return its objective value
+    unsigned long pop(const PopulationArena& arena, const usize slot) {
+        std::unique_lock lock(mutex);
+        const unsigned long k = next_pop++;
+        Buffer& buffer = buffers[k % max_depth];
+        // The buffer may still hold an earlier mutant for another pop (more pops pending than buffers)
+        const auto built_k = [&buffer, k] { return buffer.ready && buffer.index == k; };
+        if (!built_k()) {
+            // The consumption outpaces the producers: build further ahead
+            const auto t0 = std::chrono::steady_clock::now();
+            ++n_waits;
+            depth = std::min(depth + 1, max_depth);
+            space.notify_all();
+            ready.wait(lock, built_k);
+            wait_time += std::chrono::steady_clock::now() - t0;
+        }
+        arena.store(slot, buffer.mutant);
+        const unsigned long value = buffer.mutant.profile;
+        buffer.ready = false;
+        buffer.consumed = true;
+        --n_ready;
+        // Concurrent pops may finish out of order: a buffer is released only when all earlier ones are
+        while (released < next_pop && buffers[released % max_depth].consumed) {
+            buffers[released % max_depth].consumed = false;
+            ++released;
+        }
+        lock.unlock();
+        space.notify_all();
+        return value;
+    }
+
+    usize producers() const {
+        return threads.size();
+    }
+    usize currentDepth() {
+        const std::lock_guard lock(mutex);
+        return depth;
+    }
+
+    std::atomic<unsigned long> built{0}; // Mutants built by the producers
+    unsigned long n_waits = 0; // Pops that waited for a mutant (under the lock)
+    std::chrono::nanoseconds wait_time{0};
+
+private:
+    struct Buffer {
+        SolutionRK mutant;
+        unsigned long index = 0; // Mutant k in the buffer
+        bool ready = false;
+        bool consumed = false; // Popped, waiting for the earlier pops to release it
+    };
+
+    // Producer p: claim the next mutant while the queue is below its depth, build it and publish it
+    void produce(const usize p) {
+        runParallel([&] {
+            CSR& ws = workspaces[p];
+            while (true) {
+                unsigned long k;
+                {
+                    std::unique_lock lock(mutex);
+                    if (!stopping && next_claim >= released + depth && n_ready >= depth) {
+                        // Full queue: the consumption is slower than the producers
+                        depth = std::max(depth - 1, min_depth);
+                    }
+                    space.wait(lock, [this] { return stopping || next_claim < released + depth; });
+                    if (stopping)
+                        return;
+                    k = next_claim++;
+                }
+
+                const ScopedRNG stream(streamRNG(seed, k));
+                const unsigned long value = build(ws);
+
+                {
+                    const std::lock_guard lock(mutex);
+                    Buffer& buffer = buffers[k % max_depth];
+                    buffer.index = k;
+                    buffer.mutant.profile = value;
+                    buffer.mutant.random_keys.assign(ws.random_keys.begin(), ws.random_keys.end());
+                    buffer.mutant.labels.assign(ws.labels.begin(), ws.labels.end());
+                    buffer.ready = true;
+                    ++n_ready;
+                }
+                ++built;
+                ready.notify_all();
+            }
+        });
+    }
+
+    BUILD build;
+    const uint64_t seed;
+    const usize min_depth, max_depth;
+    usize depth; // Mutants claimed ahead of the consumption (under the lock)
+    std::vector<Buffer> buffers; // Ring of max_depth mutants (mutant k in buffer k % max_depth)
+    unsigned long next_claim = 0, next_pop = 0;
+    unsigned long released = 0; // Lowest mutant not popped yet (mutant k may reuse buffer k % max_depth if k < released + max_depth)
+    usize n_ready = 0;
+    bool stopping = false;
+    std::mutex mutex;
+    std::condition_variable ready, space;
+    std::vector<CSR> workspaces;
+    std::vector<std::thread> threads;
+};
+
+#endif /* MUTANT_FACTORY_H */
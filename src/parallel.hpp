@@ -0,0 +1,262 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "types.hpp"
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <pthread.h>
+
+// Number of threads used by the parallel loops
+inline usize num_threads = std::max(1u, std::thread::hardware_concurrency());
+// The thread runs a chunk or a task of a parallel loop (nested loops run serially)
+inline thread_local bool in_parallel = false;
+
+// Number of chunks (at most num_threads) of at least GRAIN elements in [0, n)
+inline usize numChunks(const usize n, const usize GRAIN) {
+    if (in_parallel)
+        return 1;
+    return std::clamp<usize>(n / std::max<usize>(GRAIN, 1), 1, num_threads);
+}
+
+// At most n threads (and at least 1) for the parallel loops started in the scope (num_threads restored on exit)
+// Inside a parallel loop it does nothing: the nested loops run serially and num_threads belongs to the outer one
+class ScopedThreads {
+public:
+    explicit ScopedThreads(const usize n) : saved(num_threads), active(!in_parallel) {
+        if (active)
+            num_threads = std::clamp<usize>(n, 1, saved);
+    }
+    ~ScopedThreads() {
+        if (active)
+            num_threads = saved;
+    }
+    ScopedThreads(const ScopedThreads&) = delete;
+    ScopedThreads& operator=(const ScopedThreads&) = delete;
+
+private:
+    const usize saved;
+    const bool active;
+};
+
+// Run fn on the calling thread marked as inside a parallel loop
+template <typename F>
+void runParallel(F&& fn) {
+    const bool outer = in_parallel;
+    in_parallel = true;
+    fn();
+    in_parallel = outer;
+}
+
+// Threads of parallelFor and parallelTasks, created on first use and reused by every call (see threadPool)
+// run(workers, job) runs job(w) for each w in [0, workers), w = 0 on the calling thread and the others on
+// the threads of the pool (created when more are needed), and returns when all of them have finished.
+// Calls from different threads run one after the other
+class ThreadPool {
+public:
+    template <typename F>
+    void run(const usize workers, F& job) {
+        if (workers <= 1) {
+            job(0u);
+            return;
+        }
+        const std::lock_guard batch_guard(dispatch);
+        {
+            const std::lock_guard lock(mutex);
+            while (threads.size() + 1 < workers)
+                threads.emplace_back(&ThreadPool::loop, this, threads.size() + 1, batch);
+            invoke = [](void* job, const usize worker) { (*static_cast<F*>(job))(worker); };
+            this->job = const_cast<void*>(static_cast<const void*>(&job));
+            active = workers;
+            pending = workers - 1;
+            ++batch;
+        }
+        start.notify_all();
+        job(0u);
+        std::unique_lock lock(mutex);
+        done.wait(lock, [this] { return pending == 0; });
+    }
+
+private:
+    // Thread of worker: runs its part of every batch with more than worker workers
+    void loop(const usize worker, unsigned long seen) {
+        std::unique_lock lock(mutex);
+        while (true) {
+            start.wait(lock, [this, seen] { return batch != seen; });
+            seen = batch;
+            if (worker >= active)
+                continue;
+            lock.unlock();
+            invoke(job, worker);
+            lock.lock();
+            if (--pending == 0)
+                done.notify_one();
+        }
+    }
+
+    std::mutex dispatch; // Held by the caller of run
+    std::mutex mutex;
+    std::condition_variable start, done;
+    std::vector<std::thread> threads; // Thread of worker w + 1 (they wait for batches until the program exits)
+    void (*invoke)(void*, usize) = nullptr; // Job of the current batch
+    void* job = nullptr;
+    unsigned long batch = 0;
+    usize active = 0, pending = 0; // Workers of the batch and pool threads still running it
+};
+
+// Pool of the process. It is never destroyed (its threads wait for work until the program exits), and a
+// forked child, which does not inherit the threads, starts a pool of its own
+inline ThreadPool* thread_pool = nullptr;
+inline std::mutex thread_pool_lock;
+inline ThreadPool& threadPool() {
+    const std::lock_guard lock(thread_pool_lock);
+    if (thread_pool == nullptr) {
+        static const int registered = pthread_atfork(nullptr, nullptr, [] { thread_pool = nullptr; });
+        (void)registered;
+        thread_pool = new ThreadPool;
+    }
+    return *thread_pool;
+}
+
+// Run fn(chunk, begin, end) for each chunk of [0, n) in parallel (see numChunks)
+// Fixed chunks, for blocks of equal cost (per-chunk buffers such as histograms); see parallelTasks otherwise
+// The calling thread runs the first chunk and the threads of the pool the others
+template <typename F>
+void parallelFor(const usize n, const usize GRAIN, F&& fn) {
+    const usize chunks = numChunks(n, GRAIN);
+    const auto bound = [n, chunks](const usize c) {
+        return static_cast<usize>((static_cast<unsigned long>(c) * n) / chunks);
+    };
+    if (chunks == 1) {
+        fn(0u, 0u, n);
+        return;
+    }
+
+    const auto chunk = [&fn, &bound](const usize c) {
+        runParallel([&] { fn(c, bound(c), bound(c + 1)); });
+    };
+    threadPool().run(chunks, chunk);
+}
+
+// Number of workers of parallelTasks for n tasks (at most num_threads)
+inline usize numWorkers(const usize n) {
+    return in_parallel ? 1 : std::clamp<usize>(n, 1, num_threads);
+}
+
+// Work of a worker of parallelTasks (accumulated over the calls that pass it)
+struct alignas(64) TaskStats {
+    std::chrono::nanoseconds busy{0}; // Time running tasks
+    unsigned long tasks = 0;
+    unsigned long batches = 0; // Tasks taken together
+    unsigned long steals = 0; // Ranges of tasks taken from other workers
+};
+
+// Range of tasks [begin, end) of a worker of parallelTasks: the owner takes from the front, thieves from the back
+struct alignas(64) TaskRange {
+    std::mutex lock;
+    usize begin = 0, end = 0;
+};
+
+// Ranges of the workers of the last parallelTasks of the calling thread (grown when more are needed)
+inline thread_local std::unique_ptr<TaskRange[]> task_ranges;
+inline thread_local usize task_ranges_size = 0;
+
+// Run fn(worker, task) for each task of [0, n) on numWorkers(n) workers (work stealing)
+// Each worker starts with a contiguous range of tasks and takes batches from its front; the batch grows while
+// the tasks are short (about TASK_BATCH_NS per batch, at most half of the range) and is one task when they are
+// long. An idle worker steals the back half of the range of another worker, so tasks of very different costs
+// (mutants and offspring) are balanced. The calling thread is worker 0 and the threads of the pool the others
+// stats (if not null, at least numWorkers(n) entries): busy time, tasks, batches and steals of each worker
+template <typename F>
+void parallelTasks(const usize n, F&& fn, std::vector<TaskStats>* stats = nullptr) {
+    constexpr realT TASK_BATCH_NS = 50000;
+    constexpr usize MAX_BATCH = 64;
+    const usize workers = numWorkers(n);
+    if (workers == 1) {
+        // One batch on the calling thread (nested in a task, or a single task)
+        const auto t0 = std::chrono::steady_clock::now();
+        runParallel([&] {
+            for (usize task = 0; task < n; ++task)
+                fn(0u, task);
+        });
+        if (stats != nullptr && n > 0) {
+            TaskStats& st = (*stats)[0];
+            st.busy += std::chrono::steady_clock::now() - t0;
+            st.tasks += n;
+            ++st.batches;
+        }
+        return;
+    }
+
+    if (task_ranges_size < workers) {
+        task_ranges.reset(new TaskRange[workers]);
+        task_ranges_size = workers;
+    }
+    TaskRange* const ranges = task_ranges.get();
+    for (usize w = 0; w < workers; ++w) {
+        ranges[w].begin = static_cast<usize>((static_cast<unsigned long>(w) * n) / workers);
+        ranges[w].end = static_cast<usize>((static_cast<unsigned long>(w + 1) * n) / workers);
+    }
+
+    const auto work = [&](const usize worker) {
+        TaskStats local;
+        TaskRange& own = ranges[worker];
+        realT task_ns = 0; // Mean time of the tasks of the last batch
+        runParallel([&] {
+            while (true) {
+                usize first, last;
+                {
+                    const std::lock_guard guard(own.lock);
+                    const usize left = own.end - own.begin;
+                    const usize batch = task_ns > 0 ? std::clamp<usize>(static_cast<usize>(TASK_BATCH_NS / task_ns), 1, MAX_BATCH) : 1;
+                    first = own.begin;
+                    last = first + std::min(batch, std::max<usize>(left / 2, std::min<usize>(left, 1)));
+                    own.begin = last;
+                }
+
+                if (first == last) {
+                    // Steal the back half of the range of another worker (none left: done)
+                    for (usize k = 1; k < workers && first == last; ++k) {
+                        TaskRange& victim = ranges[(worker + k) % workers];
+                        const std::lock_guard guard(victim.lock);
+                        const usize left = victim.end - victim.begin;
+                        if (left > 0) {
+                            first = victim.end - (left + 1) / 2;
+                            last = victim.end;
+                            victim.end = first;
+                        }
+                    }
+                    if (first == last)
+                        break;
+                    ++local.steals;
+                    const std::lock_guard guard(own.lock);
+                    own.begin = first;
+                    own.end = last;
+                    continue;
+                }
+
+                const auto t0 = std::chrono::steady_clock::now();
+                for (usize task = first; task < last; ++task)
+                    fn(worker, task);
+                const std::chrono::nanoseconds elapsed = std::chrono::steady_clock::now() - t0;
+                task_ns = static_cast<realT>(elapsed.count()) / (last - first);
+                local.busy += elapsed;
+                local.tasks += last - first;
+                ++local.batches;
+            }
+        });
+        if (stats != nullptr) {
+            TaskStats& st = (*stats)[worker];
+            st.busy += local.busy;
+            st.tasks += local.tasks;
+            st.batches += local.batches;
+            st.steals += local.steals;
+        }
+    };
+
+    threadPool().run(workers, work);
+}
+
+#endif
\ No newline at end of file
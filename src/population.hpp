@@ -0,0 +1,99 @@
+#ifndef POPULATION_H
+#define POPULATION_H
+
+#include "csr.hpp"
+#include "random_keys.hpp"
+#include <memory>
+#include <new>
+
+// Individual of a ranked population: objective value and slot of its chromosome in the arena
+struct Ranked {
+    unsigned long profile; // Objective function value
+    usize slot;
+
+    bool operator<(const Ranked& other) const {
+        return profile < other.profile || (profile == other.profile && slot < other.slot);
+    }
+};
+
+// Chromosomes of BRKGA-Pr as the rows (slots) of two contiguous matrices in one 64-byte aligned arena:
+// keys and labels; every row starts on a cache line, so workers writing different slots do not share
+// lines. The inverse of the labels is kept only by the workspaces (load rebuilds it). A population is an
+// array of Ranked: sorting, elitism and the swap of generations only permute slot indices. A lean arena
+// (labels = false) stores only the keys: the labels are decoded from them when needed
+class PopulationArena {
+public:
+    PopulationArena(const usize slots, const usize m, const bool labels = true)
+        : n_slots(slots), m(m), keys_row(lineBytes(m * sizeof(rkT))), labels_row(labels ? lineBytes(m * sizeof(usize)) : 0),
+          memory(static_cast<std::byte*>(::operator new[](bytes(), std::align_val_t{ALIGN}))) {}
+
+    usize slots() const {
+        return n_slots;
+    }
+    // The arena stores labels (not lean)
+    bool hasLabels() const {
+        return labels_row > 0;
+    }
+    // Bytes of the arena
+    size_t bytes() const {
+        return n_slots * (keys_row + labels_row);
+    }
+
+    // Rows of slot (labels only if hasLabels)
+    rkT* keys(const usize slot) const {
+        return reinterpret_cast<rkT*>(memory.get() + slot * keys_row);
+    }
+    usize* labels(const usize slot) const {
+        return reinterpret_cast<usize*>(memory.get() + n_slots * keys_row + slot * labels_row);
+    }
+
+    // Store the chromosome of csr (random_keys and labels) in slot
+    void store(const usize slot, const CSR& csr) const {
+        std::copy_n(csr.random_keys.data(), m, keys(slot));
+        if (hasLabels()) {
+            std::copy_n(csr.labels.data(), m, labels(slot));
+        }
+    }
+    // Load the chromosome in slot into csr, with the inverse of its labels (only the keys if lean)
+    void load(const usize slot, CSR& csr) const {
+        csr.random_keys.assign(keys(slot), keys(slot) + m);
+        if (hasLabels()) {
+            csr.labels.assign(labels(slot), labels(slot) + m);
+            invertLabels(csr);
+        }
+    }
+
+    // Copy of the individual in slot (for migration; no labels if lean)
+    SolutionRK solution(const usize slot, const unsigned long profile) const {
+        SolutionRK copy{profile, {}, std::vector<rkT>(keys(slot), keys(slot) + m)};
+        if (hasLabels())
+            copy.labels.assign(labels(slot), labels(slot) + m);
+        return copy;
+    }
+    // Store an individual in slot (with labels unless lean)
+    void store(const usize slot, const SolutionRK& solution) const {
+        std::copy_n(solution.random_keys.data(), m, keys(slot));
+        if (hasLabels())
+            std::copy_n(solution.labels.data(), m, labels(slot));
+    }
+
+private:
+    static constexpr size_t ALIGN = 64;
+
+    // Bytes rounded up to a cache line
+    static size_t lineBytes(const size_t bytes) {
+        return (bytes + ALIGN - 1) / ALIGN * ALIGN;
+    }
+
+    struct Free {
+        void operator()(std::byte* p) const {
+            ::operator delete[](p, std::align_val_t{ALIGN});
+        }
+    };
+
+    const usize n_slots, m;
+    const size_t keys_row, labels_row; // Bytes of a row (multiple of ALIGN)
+    std::unique_ptr<std::byte[], Free> memory;
+};
+
+#endif /* POPULATION_H */
@@ -0,0 +1,118 @@
+#include "brkga.hpp"
+#include "shared_board.hpp"
+#include <sched.h>
+#include <sys/prctl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <csignal>
+#include <cstring>
+
+// CPUs of the process split into n contiguous sets, one per island process (the sockets when their CPUs
+// are numbered consecutively); with fewer CPUs than processes each set has one CPU, shared
+std::vector<cpu_set_t> islandCPUs(const usize n) {
+    cpu_set_t available;
+    CPU_ZERO(&available);
+    sched_getaffinity(0, sizeof(cpu_set_t), &available);
+    std::vector<int> cpus;
+    for (int c = 0; c < CPU_SETSIZE; ++c) {
+        if (CPU_ISSET(c, &available))
+            cpus.push_back(c);
+    }
+
+    std::vector<cpu_set_t> sets(n);
+    const usize n_cpus = cpus.size();
+    for (usize k = 0; k < n; ++k) {
+        CPU_ZERO(&sets[k]);
+        if (n_cpus < n) {
+            CPU_SET(cpus[k % n_cpus], &sets[k]);
+            continue;
+        }
+        for (usize c = k * n_cpus / n; c < (k + 1) * n_cpus / n; ++c)
+            CPU_SET(cpus[c], &sets[k]);
+    }
+    return sets;
+}
+
+// Island process k: pinned to its CPUs, evolves its own copy of the graph (first touched on those CPUs)
+// and leaves its best solution on the board; it dies with the launcher
+[[noreturn]] void islandProcess(const CSR& csr, SharedBoard& board, const cpu_set_t& cpus, const usize k, const uint64_t seed,
+                                const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt) {
+    signal(SIGTERM, SIG_DFL);
+    prctl(PR_SET_PDEATHSIG, SIGTERM);
+    if (sched_setaffinity(0, sizeof(cpu_set_t), &cpus) != 0)
+        std::cerr << "\nIsland process " << k << ": sched_setaffinity failed (" << std::strerror(errno) << ")" << std::endl;
+    num_threads = std::clamp<usize>(CPU_COUNT(&cpus), 1, num_threads);
+    getRNG() = streamRNG(seed, k);
+
+    CSR local(csr);
+    // Arrays of its own, first touched after the pinning (a copy of csr would share the launcher's)
+    local.setGraph(*csr.graph);
+    SharedMigration migration(board, opt.topology);
+    BRKGAOptions island_opt = opt;
+    island_opt.processes = 1;
+    island_opt.islands = 1;
+    island_opt.verbose = false;
+    brkga(local, P, E, R, PROB, INIT, island_opt, &migration, k);
+
+    local.evaluateOrdering<METRIC_ALL>();
+    board.setResult(k, local.metrics.value(opt.objective), local.labels);
+    _exit(EXIT_SUCCESS);
+}
+
+/**** BRKGA-Pr on opt.processes island processes
+Every island is a forked process pinned to a disjoint set of CPUs; the islands migrate their best keys
+through a SharedBoard (see BRKGAOptions for the migration) and the launcher waits for them and keeps
+the best solution in csr
+*/
+void brkgaProcesses(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt) {
+    const usize n = opt.processes;
+    SharedBoard board(n, csr.m, std::min({opt.migrants, E, P - E}));
+    const std::vector<cpu_set_t> cpus = islandCPUs(n);
+    const uint64_t seed = getRNG()();
+    // The islands decode the keys of the others
+    prepareDecoder(csr, opt.decoder);
+
+    std::cout.flush();
+    std::vector<pid_t> children(n);
+    for (usize k = 0; k < n; ++k) {
+        children[k] = fork();
+        if (children[k] < 0) {
+            std::cerr << "\nIsland processes: fork failed (" << std::strerror(errno) << ")" << std::endl;
+            exit(EXIT_FAILURE);
+        }
+        if (children[k] == 0)
+            islandProcess(csr, board, cpus[k], k, seed, P, E, R, PROB, INIT, opt);
+    }
+    for (const pid_t child : children)
+        waitpid(child, nullptr, 0);
+
+    /// Best island
+    bool found = false;
+    unsigned long best_value = std::numeric_limits<unsigned long>::max();
+    std::vector<usize> labels;
+    for (usize k = 0; k < n; ++k) {
+        unsigned long value;
+        if (!board.result(k, value, labels)) {
+            if (opt.verbose)
+                std::cout << "Process " << k << ": no result\n";
+            continue;
+        }
+        if (opt.verbose)
+            std::cout << "Process " << k << " (" << CPU_COUNT(&cpus[k]) << " CPUs): best " << value << '\n';
+        if (value < best_value) {
+            best_value = value;
+            csr.labels = labels;
+            found = true;
+        }
+    }
+    if (!found) {
+        std::cerr << "\nIsland processes: no process returned a solution" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+
+    csr.inverse.resize(csr.m);
+    for (usize i = 0; i < csr.m; ++i)
+        csr.inverse[csr.labels[i]] = i;
+    csr.evaluateProfile();
+    csr.best_profile = csr.profile;
+}
@@ -0,0 +1,121 @@
+#ifndef RADIX_SORT_H
+#define RADIX_SORT_H
+
+#include "types.hpp"
+#include "parallel.hpp"
+#include <array>
+#include <type_traits>
+
+// LSD radix sort of a by key(element), an unsigned integer (11-bit digits)
+// Stable: elements with equal keys keep their order in a
+// tmp is the scratch buffer (resized to a.size()); the result is left in a (a and tmp may be swapped)
+// Passes where every element has the same digit are skipped
+template <typename T, typename KeyFn>
+void radixSort(std::vector<T>& a, std::vector<T>& tmp, KeyFn key) {
+    using K = std::invoke_result_t<KeyFn, const T&>;
+    static_assert(std::is_unsigned_v<K>, "radixSort: key must be an unsigned integer");
+    constexpr usize DIGIT = 11;
+    constexpr usize RADIX = 1 << DIGIT;
+    constexpr usize PASSES = (sizeof(K) * 8 + DIGIT - 1) / DIGIT;
+    const usize n = a.size();
+    if (n < 2)
+        return;
+    tmp.resize(n);
+
+    /// Histograms of every pass in a single read of a
+    std::array<std::array<usize, RADIX>, PASSES> count{};
+    for (usize i = 0; i < n; ++i) {
+        const K k = key(a[i]);
+        for (usize p = 0; p < PASSES; ++p)
+            ++count[p][(k >> (p * DIGIT)) & (RADIX - 1)];
+    }
+
+    T* src = a.data();
+    T* dst = tmp.data();
+    for (usize p = 0; p < PASSES; ++p) {
+        // Skip a pass with a single digit value
+        const K first_digit = (key(src[0]) >> (p * DIGIT)) & (RADIX - 1);
+        if (count[p][first_digit] == n)
+            continue;
+
+        // Exclusive prefix sums: first position of each digit
+        usize sum = 0;
+        for (usize d = 0; d < RADIX; ++d) {
+            const usize c = count[p][d];
+            count[p][d] = sum;
+            sum += c;
+        }
+
+        for (usize i = 0; i < n; ++i) {
+            const usize d = (key(src[i]) >> (p * DIGIT)) & (RADIX - 1);
+            dst[count[p][d]++] = src[i];
+        }
+        std::swap(src, dst);
+    }
+
+    // The sorted data is in the scratch buffer
+    if (src != a.data())
+        std::swap(a, tmp);
+}
+
+// Parallel version of radixSort with per-chunk histograms (same result with any number of threads)
+// Each pass counts the digits of every chunk, computes the offsets digit-major/chunk-minor
+// and scatters the chunks concurrently, which keeps the sort stable
+template <typename T, typename KeyFn>
+void parallelRadixSort(std::vector<T>& a, std::vector<T>& tmp, KeyFn key) {
+    using K = std::invoke_result_t<KeyFn, const T&>;
+    static_assert(std::is_unsigned_v<K>, "parallelRadixSort: key must be an unsigned integer");
+    constexpr usize DIGIT = 11;
+    constexpr usize RADIX = 1 << DIGIT;
+    constexpr usize PASSES = (sizeof(K) * 8 + DIGIT - 1) / DIGIT;
+    constexpr usize GRAIN = 1 << 16;
+    const usize n = a.size();
+    if (n < 2)
+        return;
+    tmp.resize(n);
+
+    const usize chunks = numChunks(n, GRAIN);
+    std::vector<usize> count(chunks * RADIX);
+    T* src = a.data();
+    T* dst = tmp.data();
+    for (usize p = 0; p < PASSES; ++p) {
+        const usize shift = p * DIGIT;
+
+        parallelFor(n, GRAIN, [&](const usize c, const usize begin, const usize end) {
+            usize* h = &count[c * RADIX];
+            std::fill(h, h + RADIX, 0);
+            for (usize i = begin; i < end; ++i)
+                ++h[(key(src[i]) >> shift) & (RADIX - 1)];
+        });
+
+        // Skip a pass with a single digit value
+        const usize first_digit = (key(src[0]) >> shift) & (RADIX - 1);
+        usize n_first = 0;
+        for (usize c = 0; c < chunks; ++c)
+            n_first += count[c * RADIX + first_digit];
+        if (n_first == n)
+            continue;
+
+        // Exclusive prefix sums in (digit, chunk) order
+        usize sum = 0;
+        for (usize d = 0; d < RADIX; ++d) {
+            for (usize c = 0; c < chunks; ++c) {
+                const usize x = count[c * RADIX + d];
+                count[c * RADIX + d] = sum;
+                sum += x;
+            }
+        }
+
+        parallelFor(n, GRAIN, [&](const usize c, const usize begin, const usize end) {
+            usize* offset = &count[c * RADIX];
+            for (usize i = begin; i < end; ++i)
+                dst[offset[(key(src[i]) >> shift) & (RADIX - 1)]++] = src[i];
+        });
+        std::swap(src, dst);
+    }
+
+    if (src != a.data())
+        std::swap(a, tmp);
+}
+
+#endif
\ No newline at end of file
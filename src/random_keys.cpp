@@ -1,8 +1,57 @@
 #include "random_keys.hpp"
-#include "misc.hpp"
+#include "keys.hpp"
+
+// Verification builds (make debug/verify) check every decoded labeling
+inline void verifyDecoded([[maybe_unused]] const CSR& csr) {
+#ifdef VERIFY
+    if (!isPermutation(csr.labels, csr.m)) {
+        std::cerr << "\n Decoder: labels are not a permutation!" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+#endif
+}
+
+// Assign labels and their inverse from the sorted indexed_rk (with the fingerprint of the labels if not null)
+void assignLabels(CSR& csr, Fingerprint* fingerprint) {
+    const usize n = csr.m;
+
+    csr.inverse.resize(n);
+    if (fingerprint == nullptr) {
+        parallelFor(n, parallelRK(n) ? RK_BLOCK : n, [&](usize, const usize begin, const usize end) {
+            for (usize i = begin; i < end; ++i) {
+                csr.labels[i] = csr.indexed_rk[i].index;
+                csr.inverse[csr.labels[i]] = i;
+            }
+        });
+        verifyDecoded(csr);
+        return;
+    }
+
+    // Hash the labels (two per word) while they are assigned
+    Fingerprint f;
+    usize i = 0;
+    for (; i + 1 < n; i += 2) {
+        const usize l0 = csr.indexed_rk[i].index;
+        const usize l1 = csr.indexed_rk[i + 1].index;
+        csr.labels[i] = l0;
+        csr.labels[i + 1] = l1;
+        csr.inverse[l0] = i;
+        csr.inverse[l1] = i + 1;
+        f.add(static_cast<uint64_t>(l0) | (static_cast<uint64_t>(l1) << 32));
+    }
+    if (i < n) {
+        csr.labels[i] = csr.indexed_rk[i].index;
+        csr.inverse[csr.labels[i]] = i;
+        f.add(csr.labels[i]);
+    }
+    f.finish(n);
+    *fingerprint = f;
+    verifyDecoded(csr);
+}
 
 // Decode random keys into a solution to labels (SORT)
-void decoder(CSR& csr) {
+// Reference implementation (std::sort), ties are broken by the index
+void decoderSort(CSR& csr, Fingerprint* fingerprint) {
     const usize n = csr.m;
     
     for (usize i = 0; i < n; ++i)
@@ -10,25 +59,189 @@ void decoder(CSR& csr) {
     
     // Sort by the random key values
     std::sort(csr.indexed_rk.begin(), csr.indexed_rk.end(), [](const IndexedElement& a, const IndexedElement& b) {
-        return a.value < b.value;
+        return a.value < b.value || (a.value == b.value && a.index < b.index);
     });
     
     // Assign labels based on sorted order
-    for (usize i = 0; i < n; ++i)
-        csr.labels[i] = csr.indexed_rk[i].index;
+    assignLabels(csr, fingerprint);
+}
+
+// Sort indexed_rk (the keys with their indices) by key, ties broken by the index (see sortByKey)
+void sortIndexedKeys(CSR& csr) {
+    const usize n = csr.m;
+    parallelFor(n, parallelRK(n) ? RK_BLOCK : n, [&](usize, const usize begin, const usize end) {
+        for (usize i = begin; i < end; ++i)
+            csr.indexed_rk[i] = {csr.random_keys[i], i};
+    });
+    sortByKey(csr.indexed_rk, csr.radix_rk);
+}
+
+// Decode random keys into a solution to labels (LSD radix sort, see sortIndexedKeys)
+// Same labels as decoderSort
+void decoder(CSR& csr, Fingerprint* fingerprint) {
+    sortIndexedKeys(csr);
+    assignLabels(csr, fingerprint);
+}
+
+// Inverse of labels (inverse[labels[i]] = i)
+void invertLabels(CSR& csr) {
+    const usize n = csr.m;
+    csr.inverse.resize(n);
+    parallelFor(n, parallelRK(n) ? RK_BLOCK : n, [&](usize, const usize begin, const usize end) {
+        for (usize i = begin; i < end; ++i)
+            csr.inverse[csr.labels[i]] = i;
+    });
+}
+
+// Fingerprint of labels (as computed by assignLabels)
+Fingerprint fingerprintLabels(const std::vector<usize>& labels) {
+    const usize n = labels.size();
+    Fingerprint f;
+    usize i = 0;
+    for (; i + 1 < n; i += 2)
+        f.add(static_cast<uint64_t>(labels[i]) | (static_cast<uint64_t>(labels[i + 1]) << 32));
+    if (i < n)
+        f.add(labels[i]);
+    f.finish(n);
+    return f;
+}
+
+// Decode random keys as vertex priorities within level structures (labels[v]: label of v)
+// Reverse Cuthill-McKee order with the keys as tie-breakers: the root of each level structure (one per
+// connected component) is the unvisited vertex of largest key, the unvisited neighbours of each vertex
+// in the queue are queued by decreasing key (ties broken by the index) and the queue is labeled in
+// reverse, so the labels increase with the keys within the tie-breaks (as priorityEncoder)
+void levelDecoder(CSR& csr, Fingerprint* fingerprint) {
+    const usize n = csr.m;
+    sortIndexedKeys(csr);
+    const auto greater = [&csr](const usize a, const usize b) {
+        return csr.random_keys[a] > csr.random_keys[b] || (csr.random_keys[a] == csr.random_keys[b] && a > b);
+    };
+
+    // The BFS queue is the reverse order of the labels
+    csr.visited.assign(n, false);
+    csr.level_queue.resize(n);
+    usize head = 0, tail = 0;
+    for (usize r = n; r-- > 0;) {
+        const usize root = csr.indexed_rk[r].index;
+        if (csr.visited[root])
+            continue;
+        csr.visited[root] = true;
+        csr.level_queue[tail++] = root;
+        while (head < tail) {
+            const usize u = csr.level_queue[head++];
+            const usize first = tail;
+            for (usize j = csr.row_index[u]; j < csr.row_index[u + 1]; ++j) {
+                const usize w = csr.col_index[j];
+                if (!csr.visited[w]) {
+                    csr.visited[w] = true;
+                    csr.level_queue[tail++] = w;
+                }
+            }
+            std::sort(csr.level_queue.begin() + first, csr.level_queue.begin() + tail, greater);
+        }
+    }
+
+    csr.inverse.resize(n);
+    for (usize i = 0; i < n; ++i) {
+        csr.labels[csr.level_queue[i]] = n - 1 - i;
+        csr.inverse[n - 1 - i] = csr.level_queue[i];
+    }
+
+    if (fingerprint != nullptr)
+        *fingerprint = fingerprintLabels(csr.labels);
+    verifyDecoded(csr);
+}
+
+// Pseudoperipheral pair of sloanDecoder (randomized, so it is computed once)
+void sloanDecoderPP(CSR& csr) {
+    if (!csr.has_decoder_pp) {
+        csr.decoder_pp = csr.mgpsPP();
+        csr.has_decoder_pp = true;
+    }
+}
+
+// Decode random keys as the global priorities of Sloan-MGPS (labels[v]: label of v)
+// The keys are scaled to [0, m), the range of the priorities of the multilevel refinement (sloanRefine)
+// The pseudoperipheral pair (randomized) is computed once, so the labels depend only on the keys
+// As sloanMGPS, it labels the component of the pseudoperipheral vertex (connected graphs)
+void sloanDecoder(CSR& csr, Fingerprint* fingerprint) {
+    const usize n = csr.m;
+    const realT scale = static_cast<realT>(n);
+    csr.priority.resize(n);
+    for (usize v = 0; v < n; ++v)
+        csr.priority[v] = keyReal(csr.random_keys[v]) * scale;
+
+    sloanDecoderPP(csr);
+    csr.sloanMGPSPriority(static_cast<realT>(2), static_cast<realT>(1), csr.priority, csr.decoder_pp);
+    invertLabels(csr);
+
+    if (fingerprint != nullptr)
+        *fingerprint = fingerprintLabels(csr.labels);
+    verifyDecoded(csr);
+}
+
+// Decode an offspring from the sorted order of its elite parent (delta decoding)
+// The inherited keys keep the order of the parent, so only the changed keys are sorted
+// and the two sorted runs are merged in linear time
+// Ties are broken by the index as in decoder (assuming the parent order does so, which holds for
+// decoded parents and for the encoded ones unless two encoder keys are equal)
+void deltaDecoder(CSR& csr, const usize* parent_order, const std::vector<char>& changed, Fingerprint* fingerprint) {
+    const usize n = csr.m;
+    const auto less = [](const IndexedElement& a, const IndexedElement& b) {
+        return a.value < b.value || (a.value == b.value && a.index < b.index);
+    };
+
+    // Changed keys, sorted
+    csr.delta_rk.clear();
+    for (usize k = 0; k < n; ++k) {
+        if (changed[k])
+            csr.delta_rk.push_back({csr.random_keys[k], k});
+    }
+    const usize n_changed = csr.delta_rk.size();
+    sortByKey(csr.delta_rk, csr.radix_rk);
+
+    // Inherited keys in the order of the parent
+    csr.radix_rk.resize(n - n_changed);
+    usize j = 0;
+    for (usize r = 0; r < n; ++r) {
+        const usize v = parent_order[r];
+        if (!changed[v])
+            csr.radix_rk[j++] = {csr.random_keys[v], v};
+    }
+
+    std::merge(csr.radix_rk.begin(), csr.radix_rk.end(), csr.delta_rk.begin(), csr.delta_rk.end(), csr.indexed_rk.begin(), less);
+    assignLabels(csr, fingerprint);
 }
 
 // Encode a solution (Labels) into RK representation
-// Warning !!! "realT" must be double (in types.hpp) for encoder to work
+// The i-th smallest key is assigned to the key labels[i] (inverse of decoder)
 void encoder(CSR& csr) {
-    const usize n = csr.m;
+    sortedKeys(csr.m, csr.tmp_rk, [&csr](const usize i, const rkT key) {
+        csr.random_keys[csr.labels[i]] = key;
+    });
+    invertLabels(csr);
+}
 
-    // Generate RKs
-    for (usize i = 0; i < n; ++i)
-        csr.tmp_rk[i] = realRK();
+// Encode labels reusing the sorted keys of the last decoding (indexed_rk): the keys keep their values
+// and only move, as in encoder (for a Lamarckian improvement of decoded labels)
+// Returns false if two keys are equal, then the decoding of the keys may differ from labels
+bool encoderSorted(CSR& csr) {
+    bool distinct = true;
+    for (usize i = 0; i < csr.m; ++i) {
+        csr.random_keys[csr.labels[i]] = csr.indexed_rk[i].value;
+        if (i > 0 && csr.indexed_rk[i].value == csr.indexed_rk[i - 1].value)
+            distinct = false;
+    }
+    return distinct;
+}
 
-    // Sort the random key values by labels
-    std::sort(csr.tmp_rk.begin(), csr.tmp_rk.end());
-    for (usize i = 0; i < n; ++i)
-        csr.random_keys[csr.labels[i]] = csr.tmp_rk[i];
+// Encode labels into vertex priorities: the vertex labeled i gets the i-th smallest key
+// (for levelDecoder and sloanDecoder)
+void priorityEncoder(CSR& csr) {
+    sortedKeys(csr.m, csr.tmp_rk, [&csr](const usize i, const rkT key) {
+        csr.tmp_rk[i] = key;
+    });
+    for (usize v = 0; v < csr.m; ++v)
+        csr.random_keys[v] = csr.tmp_rk[csr.labels[v]];
 }
\ No newline at end of file
@@ -2,7 +2,29 @@
 #define RK_H
 #include "csr.hpp"
 
-void decoder(CSR& csr);
+// Decode random keys into labels (with the fingerprint of the labels if not null)
+void decoder(CSR& csr, Fingerprint* fingerprint = nullptr);
+// Reference decoder (std::sort), same labels as decoder
+void decoderSort(CSR& csr, Fingerprint* fingerprint = nullptr);
+// Delta decoder of an offspring, same labels as decoder
+// parent_order: labels of the parent whose keys were inherited (its keys sorted)
+// changed[k]: the key k differs from the key of that parent
+void deltaDecoder(CSR& csr, const usize* parent_order, const std::vector<char>& changed, Fingerprint* fingerprint = nullptr);
+// Decode random keys as vertex priorities within level structures
+void levelDecoder(CSR& csr, Fingerprint* fingerprint = nullptr);
+// Decode random keys as the global priorities of Sloan-MGPS
+void sloanDecoder(CSR& csr, Fingerprint* fingerprint = nullptr);
+// Pseudoperipheral pair of sloanDecoder (computed on the first call)
+void sloanDecoderPP(CSR& csr);
+// Inverse of labels into inverse (the decoders and encoder keep it)
+void invertLabels(CSR& csr);
+// Fingerprint of labels
+Fingerprint fingerprintLabels(const std::vector<usize>& labels);
+// Encode labels into random keys (inverse of decoder)
 void encoder(CSR& csr);
+// Encode labels with the keys of the last decoding (false if two keys are equal)
+bool encoderSorted(CSR& csr);
+// Encode labels into vertex priorities (keys increasing with the label)
+void priorityEncoder(CSR& csr);
 
 #endif /* RK_H */
@@ -0,0 +1,94 @@
+#ifndef RANKED_POOL_H
+#define RANKED_POOL_H
+
+#include "population.hpp"
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <thread>
+
+// Ranked population shared by the workers of the steady-state BRKGA-Pr (see brkgaSteady)
+// The ranking (value, slot), sorted, is guarded by a reader-writer lock held only to read or replace slot
+// indices; the chromosomes are read and written in the arena outside the lock. A slot read as a parent is
+// pinned until its reader releases it, and a slot evicted from the ranking is written again only when
+// its pins are released (acquire), so no worker waits on the construction of another one
+class RankedPool {
+public:
+    // ranking: the initial population, on slots < n_slots
+    RankedPool(std::vector<Ranked> ranking, const usize E, const usize n_slots)
+        : ranking(std::move(ranking)), E(E), pins(new std::atomic<usize>[n_slots]) {
+        std::sort(this->ranking.begin(), this->ranking.end());
+        for (usize slot = 0; slot < n_slots; ++slot)
+            pins[slot].store(0, std::memory_order_relaxed);
+        updateBounds();
+    }
+
+    usize size() const {
+        return ranking.size();
+    }
+
+    // Pin the individual of rank r (its slot is not written until release)
+    Ranked pin(const usize r) const {
+        const std::shared_lock lock(mutex);
+        const Ranked individual = ranking[r];
+        pins[individual.slot].fetch_add(1, std::memory_order_relaxed);
+        return individual;
+    }
+    void release(const usize slot) const {
+        pins[slot].fetch_sub(1, std::memory_order_release);
+    }
+
+    // Wait until slot (evicted from the ranking) is not pinned by any reader
+    void acquire(const usize slot) const {
+        while (pins[slot].load(std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+    }
+
+    // Offer the individual written in its slot: it replaces the worst individual if it is better
+    // (always if forced). Returns the slot the caller owns afterwards: the evicted one, or its own if rejected
+    usize offer(const Ranked individual, const bool forced) {
+        const std::unique_lock lock(mutex);
+        if (!forced && !(individual < ranking.back())) {
+            ++rejected;
+            return individual.slot;
+        }
+        const usize evicted = ranking.back().slot;
+        ranking.pop_back();
+        ranking.insert(std::upper_bound(ranking.begin(), ranking.end(), individual), individual);
+        ++accepted;
+        updateBounds();
+        return evicted;
+    }
+
+    // Values of the best individual and of the worst elite individual (without the lock)
+    unsigned long best() const {
+        return best_value.load(std::memory_order_relaxed);
+    }
+    unsigned long worstElite() const {
+        return worst_elite.load(std::memory_order_relaxed);
+    }
+
+    // Copy of the ranking
+    std::vector<Ranked> snapshot() const {
+        const std::shared_lock lock(mutex);
+        return ranking;
+    }
+
+    unsigned long accepted = 0; // Offers that entered the ranking (under the lock)
+    unsigned long rejected = 0;
+
+private:
+    void updateBounds() {
+        best_value.store(ranking.front().profile, std::memory_order_relaxed);
+        worst_elite.store(ranking[std::min<usize>(E, ranking.size()) - 1].profile, std::memory_order_relaxed);
+    }
+
+    std::vector<Ranked> ranking;
+    const usize E;
+    mutable std::shared_mutex mutex;
+    std::unique_ptr<std::atomic<usize>[]> pins; // Readers of each slot
+    std::atomic<unsigned long> best_value, worst_elite;
+};
+
+#endif /* RANKED_POOL_H */
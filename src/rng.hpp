@@ -0,0 +1,65 @@
+#ifndef RNG_H
+#define RNG_H
+
+#include "types.hpp"
+
+// SplitMix64 step: seeds the generators and derives streams
+inline uint64_t splitMix64(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+// xoshiro256** (Blackman and Vigna, 2018): fast 64-bit generator, period 2^256 - 1
+// Satisfies UniformRandomBitGenerator (usable with the std distributions)
+class Xoshiro256 {
+public:
+    using result_type = uint64_t;
+
+    explicit Xoshiro256(uint64_t seed = 0) {
+        for (auto& word : s)
+            word = splitMix64(seed);
+    }
+
+    // Restart from seed
+    void seed(const uint64_t seed) {
+        *this = Xoshiro256(seed);
+    }
+
+    static constexpr result_type min() {
+        return 0;
+    }
+    static constexpr result_type max() {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    result_type operator()() {
+        const uint64_t result = std::rotl(s[1] * 5, 7) * 9;
+        const uint64_t t = s[1] << 17;
+        s[2] ^= s[0];
+        s[3] ^= s[1];
+        s[1] ^= s[2];
+        s[0] ^= s[3];
+        s[2] ^= t;
+        s[3] = std::rotl(s[3], 45);
+        return result;
+    }
+
+    // Real number in [0, 1) (53 random bits)
+    realT real() {
+        return static_cast<realT>((*this)() >> 11) * 0x1.0p-53;
+    }
+
+private:
+    uint64_t s[4];
+};
+
+// Generator of the stream `stream` of seed
+// Streams of the same seed are independent (the state is expanded from a different SplitMix64 seed)
+inline Xoshiro256 streamRNG(const uint64_t seed, const uint64_t stream) {
+    uint64_t state = seed ^ (stream * 0xD1B54A32D192ED03ULL);
+    return Xoshiro256(splitMix64(state));
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,81 @@
+#include "brkga.hpp"
+#include <iomanip>
+
+// Solution of one run of the multi-start BRKGA-Pr
+struct RunSolution {
+    OrderingMetrics metrics; // All metrics of the best individual
+    std::vector<usize> labels;
+    std::chrono::nanoseconds time{0};
+};
+
+/**** Multi-start BRKGA-Pr: opt.runs independent runs on the graph loaded once
+Each run has its own random stream (from the seed of the program and the index of the run) and the whole
+time budget, and works on a copy of csr: its own buffers on the shared graph (see CSR). The runs are the
+tasks of parallelTasks, each one serially with its islands and producers (serialThreads), so up to
+num_threads / serialThreads of them run at once and the others wait for a free thread. The best, mean and standard deviation of the objective and the permutation of every
+run are reported, and the best run is left in csr
+*/
+void brkgaRuns(CSR& csr, const usize P, const usize E, const usize R, const realT PROB, const usize INIT, const BRKGAOptions& opt) {
+    const usize n = opt.runs;
+    const uint64_t seed = getRNG()();
+    // The runs share the precomputation of the decoder
+    prepareDecoder(csr, opt.decoder);
+    BRKGAOptions run_opt = opt;
+    run_opt.runs = 1;
+    run_opt.processes = 1;
+    run_opt.verbose = false;
+
+    std::vector<RunSolution> solutions(n);
+    const ScopedThreads concurrent(num_threads / serialThreads(run_opt));
+    std::vector<TaskStats> work(numWorkers(n));
+    if (opt.verbose)
+        std::cout << "Runs: " << n << " on " << work.size() << " threads\n";
+    parallelTasks(n, [&](usize, const usize run) {
+        const auto start = std::chrono::steady_clock::now();
+        const ScopedRNG stream(streamRNG(seed, run));
+        CSR local(csr); // Workspace of the run
+        brkga(local, P, E, R, PROB, INIT, run_opt);
+        local.evaluateOrdering<METRIC_ALL>();
+        solutions[run] = {local.metrics, std::move(local.labels), std::chrono::steady_clock::now() - start};
+    }, &work);
+
+    /// Best run and statistics of the objective
+    usize best = 0;
+    realT sum = 0, sum_sq = 0;
+    for (usize run = 0; run < n; ++run) {
+        const unsigned long value = solutions[run].metrics.value(opt.objective);
+        if (value < solutions[best].metrics.value(opt.objective))
+            best = run;
+        sum += static_cast<realT>(value);
+        sum_sq += static_cast<realT>(value) * static_cast<realT>(value);
+    }
+    const realT mean = sum / n;
+    // Sample standard deviation
+    const realT sd = n > 1 ? std::sqrt(std::max<realT>(0, (sum_sq - n * mean * mean) / (n - 1))) : 0;
+
+    if (opt.verbose) {
+        for (usize run = 0; run < n; ++run) {
+            const RunSolution& s = solutions[run];
+            std::cout << "Run " << run << ": profile " << s.metrics.profile << ", bandwidth " << s.metrics.bandwidth
+                      << ", max wavefront " << s.metrics.max_wavefront << ", RMS wavefront " << s.metrics.rmsWavefront()
+                      << ", envelope " << s.metrics.envelope << " (" << std::chrono::duration<realT>(s.time).count() << " s)\n";
+        }
+        std::ostringstream stats;
+        stats << std::fixed << std::setprecision(2) << "mean " << mean << ", standard deviation " << sd;
+        std::cout << "Runs: best " << solutions[best].metrics.value(opt.objective) << " (run " << best << "), " << stats.str() << '\n';
+        // Label of each vertex
+        for (usize run = 0; run < n; ++run) {
+            std::cout << "Permutation of run " << run << ":";
+            for (const usize label : solutions[run].labels)
+                std::cout << ' ' << label;
+            std::cout << '\n';
+        }
+    }
+
+    csr.labels = std::move(solutions[best].labels);
+    csr.inverse.resize(csr.m);
+    for (usize i = 0; i < csr.m; ++i)
+        csr.inverse[csr.labels[i]] = i;
+    csr.evaluateProfile();
+    csr.best_profile = csr.profile;
+}
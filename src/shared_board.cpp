@@ -0,0 +1,135 @@
+#include "shared_board.hpp"
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstring>
+
+// Bytes rounded up to a cache line (the outboxes and results of the islands do not share lines)
+static size_t cacheLines(const size_t bytes) {
+    return (bytes + 63) / 64 * 64;
+}
+
+// The segment is unlinked as soon as it is mapped: it lives while this process or its children map it
+SharedBoard::SharedBoard(const usize n_islands, const usize m, const usize migrants)
+    : n_islands(n_islands), m(m), capacity(migrants) {
+    outbox_bytes = cacheLines(sizeof(Outbox) + capacity * sizeof(unsigned long) + static_cast<size_t>(capacity) * m * sizeof(rkT));
+    result_bytes = cacheLines(sizeof(Result) + static_cast<size_t>(m) * sizeof(usize));
+    bytes = cacheLines(sizeof(Header)) + n_islands * (outbox_bytes + result_bytes);
+
+    const std::string name = "/brkga-board-" + std::to_string(getpid());
+    const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+    if (fd < 0) {
+        std::cerr << "\nShared board: shm_open failed (" << std::strerror(errno) << ")" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    shm_unlink(name.c_str());
+    if (ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "\nShared board: ftruncate of " << bytes << " bytes failed (" << std::strerror(errno) << ")" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    void* address = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (address == MAP_FAILED) {
+        std::cerr << "\nShared board: mmap failed (" << std::strerror(errno) << ")" << std::endl;
+        exit(EXIT_FAILURE);
+    }
+    base = static_cast<char*>(address);
+
+    // The segment is zero-filled; the atomics are lock-free, so they work across processes
+    new (header()) Header{};
+    for (usize island = 0; island < n_islands; ++island) {
+        new (outbox(island)) Outbox{};
+        new (resultSlot(island)) Result{};
+    }
+}
+
+SharedBoard::~SharedBoard() {
+    if (base != nullptr)
+        munmap(base, bytes);
+}
+
+SharedBoard::Header* SharedBoard::header() const {
+    return reinterpret_cast<Header*>(base);
+}
+
+SharedBoard::Outbox* SharedBoard::outbox(const usize island) const {
+    return reinterpret_cast<Outbox*>(base + cacheLines(sizeof(Header)) + island * outbox_bytes);
+}
+
+unsigned long* SharedBoard::outboxValues(const usize island) const {
+    return reinterpret_cast<unsigned long*>(reinterpret_cast<char*>(outbox(island)) + sizeof(Outbox));
+}
+
+rkT* SharedBoard::outboxKeys(const usize island) const {
+    return reinterpret_cast<rkT*>(outboxValues(island) + capacity);
+}
+
+SharedBoard::Result* SharedBoard::resultSlot(const usize island) const {
+    return reinterpret_cast<Result*>(base + cacheLines(sizeof(Header)) + n_islands * outbox_bytes + island * result_bytes);
+}
+
+usize* SharedBoard::resultLabels(const usize island) const {
+    return reinterpret_cast<usize*>(reinterpret_cast<char*>(resultSlot(island)) + sizeof(Result));
+}
+
+void SharedBoard::publish(const usize island, const std::vector<SolutionRK>& migrants) {
+    Outbox& box = *outbox(island);
+    const usize count = std::min<usize>(migrants.size(), capacity);
+    const uint64_t sequence = box.sequence.load(std::memory_order_relaxed);
+
+    box.sequence.store(sequence + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    box.count = count;
+    for (usize j = 0; j < count; ++j) {
+        outboxValues(island)[j] = migrants[j].profile;
+        std::memcpy(outboxKeys(island) + static_cast<size_t>(j) * m, migrants[j].random_keys.data(), m * sizeof(rkT));
+    }
+    box.sequence.store(sequence + 2, std::memory_order_release);
+}
+
+bool SharedBoard::read(const usize source, uint64_t& seen, std::vector<SolutionRK>& migrants) {
+    const Outbox& box = *outbox(source);
+    const uint64_t sequence = box.sequence.load(std::memory_order_acquire);
+    if (sequence == seen || (sequence & 1))
+        return false;
+
+    const usize count = std::min<usize>(box.count, capacity);
+    migrants.resize(count);
+    for (usize j = 0; j < count; ++j) {
+        migrants[j].profile = outboxValues(source)[j];
+        migrants[j].labels.clear();
+        migrants[j].random_keys.resize(m);
+        std::memcpy(migrants[j].random_keys.data(), outboxKeys(source) + static_cast<size_t>(j) * m, m * sizeof(rkT));
+    }
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (box.sequence.load(std::memory_order_relaxed) != sequence) {
+        torn.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    seen = sequence;
+    return true;
+}
+
+void SharedBoard::stop() {
+    header()->stop.store(1, std::memory_order_relaxed);
+}
+
+bool SharedBoard::stopped() const {
+    return header()->stop.load(std::memory_order_relaxed) != 0;
+}
+
+void SharedBoard::setResult(const usize island, const unsigned long value, const std::vector<usize>& labels) {
+    Result& r = *resultSlot(island);
+    r.value = value;
+    std::memcpy(resultLabels(island), labels.data(), m * sizeof(usize));
+    r.done.store(1, std::memory_order_release);
+}
+
+bool SharedBoard::result(const usize island, unsigned long& value, std::vector<usize>& labels) const {
+    const Result& r = *resultSlot(island);
+    if (r.done.load(std::memory_order_acquire) == 0)
+        return false;
+    value = r.value;
+    labels.assign(resultLabels(island), resultLabels(island) + m);
+    return true;
+}
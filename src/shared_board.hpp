@@ -0,0 +1,98 @@
+#ifndef SHARED_BOARD_H
+#define SHARED_BOARD_H
+
+#include "types.hpp"
+#include "migration.hpp"
+#include <atomic>
+
+// Migration board of island processes in a POSIX shared-memory segment (mapped before fork)
+// Each island publishes its migrants (keys and objective values) in its own outbox under a sequence lock
+// (the island is the only writer); a reader copies the outbox and drops the copy if it was written meanwhile,
+// so neither side waits. The board also holds the stop flag and the result of each island
+class SharedBoard {
+public:
+    SharedBoard(const usize n_islands, const usize m, const usize migrants);
+    ~SharedBoard();
+    SharedBoard(const SharedBoard&) = delete;
+    SharedBoard& operator=(const SharedBoard&) = delete;
+
+    usize islands() const {
+        return n_islands;
+    }
+
+    // Publish the migrants of island (at most the capacity of the outbox)
+    void publish(const usize island, const std::vector<SolutionRK>& migrants);
+    // Copy the migrants of source if published after version seen (false if none or torn)
+    // The copies have keys and values only
+    bool read(const usize source, uint64_t& seen, std::vector<SolutionRK>& migrants);
+
+    void stop();
+    bool stopped() const;
+
+    // Result of island (objective value and labels of the best solution)
+    void setResult(const usize island, const unsigned long value, const std::vector<usize>& labels);
+    // False if island did not set its result
+    bool result(const usize island, unsigned long& value, std::vector<usize>& labels) const;
+
+    std::atomic<unsigned long> torn{0}; // Reads dropped because the outbox was being written (this process)
+
+private:
+    struct Header {
+        std::atomic<uint32_t> stop;
+    };
+    struct Outbox {
+        std::atomic<uint64_t> sequence; // Odd while being written
+        uint64_t count;
+        // unsigned long values[migrants], rkT keys[migrants * m]
+    };
+    struct Result {
+        std::atomic<uint32_t> done;
+        unsigned long value;
+        // usize labels[m]
+    };
+
+    Header* header() const;
+    Outbox* outbox(const usize island) const;
+    unsigned long* outboxValues(const usize island) const;
+    rkT* outboxKeys(const usize island) const;
+    Result* resultSlot(const usize island) const;
+    usize* resultLabels(const usize island) const;
+
+    const usize n_islands, m, capacity;
+    size_t outbox_bytes, result_bytes, bytes;
+    char* base = nullptr;
+};
+
+// Islands on processes migrating through a SharedBoard (one island per process)
+// The destination reads the outbox of its source: the previous island (ring) or a random other island
+class SharedMigration final : public Migration {
+public:
+    SharedMigration(SharedBoard& board, const Topology topology) : board(board), topology(topology), seen(board.islands(), 0) {}
+
+    usize islands() const override {
+        return board.islands();
+    }
+    void send(const usize island, std::vector<SolutionRK> migrants) override {
+        board.publish(island, migrants);
+    }
+    std::vector<SolutionRK> receive(const usize island) override {
+        const usize source = migrationPeer(island, islands(), topology, false);
+        std::vector<SolutionRK> migrants;
+        if (!board.read(source, seen[source], migrants))
+            migrants.clear();
+        return migrants;
+    }
+    void stop() override {
+        board.stop();
+    }
+    bool stopped() const override {
+        return board.stopped();
+    }
+
+private:
+    SharedBoard& board;
+    const Topology topology;
+    std::vector<uint64_t> seen; // Last version read from each outbox
+};
+
+#endif /* SHARED_BOARD_H */
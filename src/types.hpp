@@ -17,10 +17,23 @@
 #include <map>
 #include <chrono>
 #include <variant>
+#include <cmath>
+#include <cstdint>
+#include <bit>
 #include "robin_hood.h"
 
 #define usize unsigned int
 #define realT double
+// Type of the random keys (the random-key pipeline in keys.hpp is templated on it)
+// make KEYS=float: single-precision keys, make KEYS=u32: 32-bit rank-quantized keys
+// (both halve the memory of the population and of the decoder)
+#if defined(RK_U32)
+  using rkT = uint32_t;
+#elif defined(RK_FLOAT)
+  using rkT = float;
+#else
+  using rkT = realT;
+#endif
 using ParamValue = std::variant<int, std::string, realT, int64_t>;
 
 // Status of vertices used in Sloan algorithm
@@ -57,6 +70,71 @@ struct CompareCostReal {
     }
 };
 
+// Metrics of an ordering computed by CSR::evaluateOrdering (bit mask)
+constexpr unsigned METRIC_PROFILE = 1;
+constexpr unsigned METRIC_BANDWIDTH = 2;
+constexpr unsigned METRIC_WAVEFRONT = 4; // Maximum and RMS wavefront
+constexpr unsigned METRIC_ENVELOPE = 8; // Envelope size (profile + diagonal)
+constexpr unsigned METRIC_ALL = METRIC_PROFILE | METRIC_BANDWIDTH | METRIC_WAVEFRONT | METRIC_ENVELOPE;
+
+// Objective function optimized by the BRKGA-Pr
+enum class Objective {
+    Profile,
+    Bandwidth,
+    MaxWavefront,
+    RmsWavefront, // Minimized as the sum of squared wavefronts
+    Envelope
+};
+
+// Decoding of the random keys into labels (policy of the BRKGA-Pr, see decoders.hpp)
+enum class Decoder {
+    Sort, // Keys sorted into labels
+    Level, // Keys as priorities within level structures
+    Sloan // Keys as the global priorities of Sloan-MGPS
+};
+
+// Destination of the migrants of an island (island model of the BRKGA-Pr)
+enum class Topology {
+    Ring, // The next island
+    Random // A random other island
+};
+
+// Metrics needed to evaluate an objective
+constexpr unsigned objectiveMetrics(const Objective OBJ) {
+    switch (OBJ) {
+        case Objective::Bandwidth: return METRIC_BANDWIDTH;
+        case Objective::MaxWavefront: return METRIC_WAVEFRONT;
+        case Objective::RmsWavefront: return METRIC_WAVEFRONT;
+        case Objective::Envelope: return METRIC_ENVELOPE;
+        default: return METRIC_PROFILE;
+    }
+}
+
+// Metrics of an ordering (only those requested to evaluateOrdering are up to date)
+struct OrderingMetrics {
+    unsigned long profile = 0; // Sum of the row widths
+    unsigned long envelope = 0; // Entries in the envelope including the diagonal (profile + m)
+    unsigned long sum_sq_wavefront = 0; // Sum of the squared wavefronts
+    usize bandwidth = 0; // Maximum row width
+    usize max_wavefront = 0; // Maximum number of active rows in an elimination step
+    usize m = 0; // Number of rows
+
+    realT rmsWavefront() const {
+        return m == 0 ? 0 : std::sqrt(static_cast<realT>(sum_sq_wavefront) / static_cast<realT>(m));
+    }
+
+    // Value of the objective function (lower is better)
+    unsigned long value(const Objective OBJ) const {
+        switch (OBJ) {
+            case Objective::Bandwidth: return bandwidth;
+            case Objective::MaxWavefront: return max_wavefront;
+            case Objective::RmsWavefront: return sum_sq_wavefront;
+            case Objective::Envelope: return envelope;
+            default: return profile;
+        }
+    }
+};
+
 using TimePoint = std::chrono::time_point<std::chrono::steady_clock>;
 
 using Duration = int64_t;
@@ -65,7 +143,7 @@ using Duration = int64_t;
 struct SolutionRK {
     unsigned long profile; // Solution objective function value
     std::vector<usize> labels; // labels == Current solution
-    std::vector<realT> random_keys; // Representation using Random Keys
+    std::vector<rkT> random_keys; // Representation using Random Keys
 
     bool operator<(const SolutionRK& other) const {
     if (profile < other.profile)
@@ -91,11 +169,41 @@ struct SolutionDR {
     }
 };
 
+// 128-bit streaming fingerprint of a labeling (two independent 64-bit lanes)
+struct Fingerprint {
+    uint64_t lo = 0x243F6A8885A308D3ULL;
+    uint64_t hi = 0x13198A2E03707344ULL;
+
+    // Add a word (two labels) to the stream
+    void add(const uint64_t w) {
+        lo = (lo ^ w) * 0x9E3779B97F4A7C15ULL;
+        lo ^= lo >> 32;
+        hi = std::rotl(hi + w, 27) * 0xC2B2AE3D27D4EB4FULL;
+    }
+
+    // Final avalanche (splitmix64 finalizer) of both lanes with the length
+    void finish(const uint64_t n) {
+        const auto mix = [](uint64_t z) {
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            return z ^ (z >> 31);
+        };
+        lo = mix(lo ^ n);
+        hi = mix(hi + lo);
+    }
+
+    bool operator==(const Fingerprint& other) const {
+        return lo == other.lo && hi == other.hi;
+    }
+};
+
 // Structure to hold element value and original index
-struct IndexedElement {
-    realT value;
+template <typename Key>
+struct IndexedKey {
+    Key value;
     usize index;
 };
+using IndexedElement = IndexedKey<rkT>;
 
 struct Element {
     usize i;
@@ -1,8 +1,24 @@
 #include "../src/csr.cpp"
 #include "../src/random_keys.cpp"
+#include "../src/decoders.hpp"
 #include "../src/heuristics.cpp"
 #include "../src/peripheral_vertices.cpp"
+#include "../src/lower_bounds.cpp"
+#include "../src/fitness_cache.hpp"
+#include "../src/crossover.hpp"
+#include "../src/mailbox.hpp"
+#include "../src/shared_board.cpp"
+#include "../src/population.hpp"
+#include "../src/ranked_pool.hpp"
+#include "../src/mutant_factory.hpp"
+#include "../src/multilevel.cpp"
+#include "../src/constructive_methods.cpp"
+#include "../src/brkga.cpp"
+#include "../src/runs.cpp"
+#include "../src/processes.cpp"
 #include <filesystem>
+#include <set>
+#include <sys/wait.h>
 
 
 std::vector<std::string> getFilesInDirectory(const std::string& directory_path) {
@@ -27,6 +43,22 @@ usize n = 0;
 // If parameter is not true, test fails
 #define IS_TRUE(x) { if (!(x)) { std::cout << "\n - " << __FUNCTION__ << ":\n\t * Failed on line :" << __LINE__ << std::endl; failed = true;} else {n++;}}
 
+// Key of type rkT with the order of the real r in [0, 1) (scaled to 32 bits for RK_U32)
+rkT keyOf(const realT r) {
+    return std::is_integral_v<rkT> ? static_cast<rkT>(r * 0x1.0p32) : static_cast<rkT>(r);
+}
+
+rkT randomKey() {
+    return keyOf(realRK());
+}
+
+std::vector<rkT> keysOf(const std::initializer_list<realT> reals) {
+    std::vector<rkT> keys;
+    for (const realT r : reals)
+        keys.push_back(keyOf(r));
+    return keys;
+}
+
 void testCSRFromFile2() {
     // %   V         = [ 3 1 3 5 4 1 5 4 ]
     // %   COL_INDEX = [ 1 3 0 3 3 0 1 2 ]
@@ -42,10 +74,10 @@ void testCSRFromFile2() {
     // IS_TRUE(csr.values == expected_v);
     // Check elements of csr.col_index
     std::vector<usize> expected_col_index = {1, 3, 0, 3, 3, 0, 1, 2};
-    IS_TRUE(csr.col_index == expected_col_index);
+    IS_TRUE(std::ranges::equal(csr.col_index, expected_col_index));
     // Check elements of csr.row_index
     std::vector<usize> expected_row_index = {0, 2, 4, 5, 8};
-    IS_TRUE(csr.row_index == expected_row_index);
+    IS_TRUE(std::ranges::equal(csr.row_index, expected_row_index));
 }
 
 void testCSRFromFile3() {
@@ -60,10 +92,25 @@ void testCSRFromFile3() {
     IS_TRUE(csr.col_index.size() == csr.n_nz);
     // Check elements of csr.col_index
     std::vector<usize> expected_col_index = {2, 5, 4, 5, 0, 3, 4, 2, 1, 2, 5, 0, 1, 4};
-    IS_TRUE(csr.col_index == expected_col_index);
+    IS_TRUE(std::ranges::equal(csr.col_index, expected_col_index));
     // Check elements of csr.row_index
     std::vector<usize> expected_row_index = {0, 2, 4, 7, 8, 11, 14};
-    IS_TRUE(csr.row_index == expected_row_index);
+    IS_TRUE(std::ranges::equal(csr.row_index, expected_row_index));
+}
+
+void testSharedGraph() {
+    // A copy of a CSR is a workspace on the same graph arrays with its own buffers
+    CSR csr("input/test2.mtx");
+    CSR ws(csr);
+    IS_TRUE(ws.graph == csr.graph && ws.row_index.data() == csr.row_index.data());
+    IS_TRUE(ws.col_index.data() == csr.col_index.data() && ws.degree.data() == csr.degree.data());
+    ws.labels[0] = 5;
+    IS_TRUE(csr.labels[0] == 0 && ws.labels.data() != csr.labels.data());
+
+    // setGraph with a copy of the arrays gives it a graph of its own
+    ws.setGraph(*csr.graph);
+    IS_TRUE(ws.graph != csr.graph && ws.col_index.data() != csr.col_index.data());
+    IS_TRUE(std::ranges::equal(ws.col_index, csr.col_index) && std::ranges::equal(ws.row_index, csr.row_index));
 }
 
 
@@ -248,6 +295,80 @@ void testProfile3() {
     IS_TRUE(csr.profile == 9);
 }
 
+void testFeasibility() {
+    CSR csr("input/test2.mtx");
+    IS_TRUE(csr.isFeasible());
+    csr.labels = {5, 3, 1, 0, 2, 4};
+    IS_TRUE(csr.isFeasible());
+    csr.labels = {5, 3, 1, 0, 2, 2};
+    IS_TRUE(!isPermutation(csr.labels, csr.m));
+    csr.labels = {5, 3, 1, 0, 2, 6};
+    IS_TRUE(!isPermutation(csr.labels, csr.m));
+    csr.labels = {5, 3, 1, 0, 2};
+    IS_TRUE(!isPermutation(csr.labels, csr.m));
+
+    // Large m (parallel chunks), one repeated label
+    std::vector<usize> l(1 << 20);
+    std::iota(l.begin(), l.end(), 0);
+    std::shuffle(l.begin(), l.end(), getRNG());
+    IS_TRUE(isPermutation(l, l.size()));
+    l[l.size() / 3] = l[l.size() / 2];
+    IS_TRUE(!isPermutation(l, l.size()));
+}
+
+void testOrderingMetrics() {
+    CSR csr("input/test1.mtx");
+    // Rows span [0, 0], [0, 1], [2, 2] and [0, 3] => wavefronts 3, 2, 2, 1
+    csr.evaluateOrdering<METRIC_ALL>();
+    IS_TRUE(csr.metrics.profile == 4);
+    IS_TRUE(csr.profile == 4);
+    IS_TRUE(csr.metrics.bandwidth == 3);
+    IS_TRUE(csr.metrics.max_wavefront == 3);
+    IS_TRUE(csr.metrics.sum_sq_wavefront == 18);
+    IS_TRUE(csr.metrics.envelope == 8);
+
+    // Single metric evaluations agree with the single pass
+    csr.labels = {1, 3, 0, 2};
+    csr.evaluateOrdering<METRIC_ALL>();
+    const OrderingMetrics all = csr.metrics;
+    IS_TRUE(all.profile == 4);
+    IS_TRUE(csr.evaluateObjective<Objective::Profile>() == all.profile);
+    IS_TRUE(csr.evaluateObjective<Objective::Bandwidth>() == all.bandwidth);
+    IS_TRUE(csr.evaluateObjective<Objective::MaxWavefront>() == all.max_wavefront);
+    IS_TRUE(csr.evaluateObjective<Objective::RmsWavefront>() == all.sum_sq_wavefront);
+    IS_TRUE(csr.evaluateObjective<Objective::Envelope>() == all.envelope);
+    // The wavefronts add up to the envelope
+    IS_TRUE(all.max_wavefront * csr.m >= all.envelope);
+}
+
+void testLowerBounds() {
+    // The bounds hold for every labeling (exhaustive on small graphs)
+    for (const std::string file : {"input/test1.mtx", "input/test2.mtx", "input/mst.mtx"}) {
+        CSR csr(file, true);
+        const OrderingMetrics lb = csr.lowerBounds();
+        OrderingMetrics best;
+        best.profile = best.envelope = best.sum_sq_wavefront = std::numeric_limits<unsigned long>::max();
+        best.bandwidth = best.max_wavefront = std::numeric_limits<usize>::max();
+
+        std::iota(csr.labels.begin(), csr.labels.end(), 0);
+        do {
+            csr.evaluateOrdering<METRIC_ALL>();
+            best.profile = std::min(best.profile, csr.metrics.profile);
+            best.envelope = std::min(best.envelope, csr.metrics.envelope);
+            best.sum_sq_wavefront = std::min(best.sum_sq_wavefront, csr.metrics.sum_sq_wavefront);
+            best.bandwidth = std::min(best.bandwidth, csr.metrics.bandwidth);
+            best.max_wavefront = std::min(best.max_wavefront, csr.metrics.max_wavefront);
+        } while (std::next_permutation(csr.labels.begin(), csr.labels.end()));
+
+        IS_TRUE(lb.profile >= csr.n_nz / 2);
+        IS_TRUE(lb.profile <= best.profile);
+        IS_TRUE(lb.envelope <= best.envelope);
+        IS_TRUE(lb.sum_sq_wavefront <= best.sum_sq_wavefront);
+        IS_TRUE(lb.bandwidth <= best.bandwidth);
+        IS_TRUE(lb.max_wavefront <= best.max_wavefront);
+    }
+}
+
 void testEncoderDecoder() {
     CSR csr(5, 10);
     csr.random_keys.resize(5);
@@ -297,6 +418,782 @@ void testEncoderDecoder() {
 }
 
 
+void testRadixDecoder() {
+    const usize size = 5000;
+    CSR csr(size, 0);
+    csr.random_keys.resize(size);
+    csr.labels.resize(size);
+    csr.indexed_rk.resize(size);
+    std::vector<usize> l;
+
+    // Distinct keys
+    for (usize i = 0; i < size; ++i)
+        csr.random_keys[i] = randomKey();
+    decoderSort(csr);
+    l = csr.labels;
+    decoder(csr);
+    IS_TRUE(l == csr.labels);
+
+    // Many ties (and zeros): both break them by the index
+    for (usize i = 0; i < size; ++i)
+        csr.random_keys[i] = usizeRandomNumber(0, 20) / 20.0;
+    decoderSort(csr);
+    l = csr.labels;
+    decoder(csr);
+    IS_TRUE(l == csr.labels);
+    bool by_index = true;
+    for (usize i = 1; i < size; ++i) {
+        if (csr.random_keys[l[i - 1]] == csr.random_keys[l[i]] && l[i - 1] > l[i])
+            by_index = false;
+    }
+    IS_TRUE(by_index);
+
+    // All keys equal: identity
+    std::fill(csr.random_keys.begin(), csr.random_keys.end(), 0.5);
+    decoder(csr);
+    IS_TRUE(std::is_sorted(csr.labels.begin(), csr.labels.end()));
+
+    // Round trip with the encoder
+    std::iota(l.begin(), l.end(), 0);
+    std::shuffle(l.begin(), l.end(), getRNG());
+    csr.labels = l;
+    csr.tmp_rk.resize(size);
+    encoder(csr);
+    decoder(csr);
+    IS_TRUE(l == csr.labels);
+}
+
+void testDeltaDecoder() {
+    const usize size = 3000;
+    CSR csr(size, 0);
+    csr.random_keys.resize(size);
+    csr.indexed_rk.resize(size);
+    csr.tmp_rk.resize(size);
+    csr.labels.resize(size);
+    std::vector<char> changed(size);
+    std::vector<usize> l;
+
+    // Elite parent: decoded keys with many ties
+    std::vector<rkT> parent(size);
+    for (usize i = 0; i < size; ++i)
+        parent[i] = usizeRandomNumber(0, 100) / 100.0;
+    csr.random_keys = parent;
+    decoder(csr);
+    const std::vector<usize> parent_order = csr.labels;
+
+    // Offspring with few, about 30% and all keys changed: same labels as the full decoder
+    for (const realT prob : {0.99, 0.7, 0.0}) {
+        for (usize k = 0; k < size; ++k) {
+            changed[k] = realRK() >= prob;
+            csr.random_keys[k] = changed[k] ? usizeRandomNumber(0, 100) / 100.0 : parent[k];
+        }
+        decoder(csr);
+        l = csr.labels;
+        deltaDecoder(csr, parent_order.data(), changed);
+        IS_TRUE(l == csr.labels);
+    }
+
+    // Encoded parent (as the initial population and the mutants)
+    std::iota(l.begin(), l.end(), 0);
+    std::shuffle(l.begin(), l.end(), getRNG());
+    csr.labels = l;
+    encoder(csr);
+    parent = csr.random_keys;
+    for (usize k = 0; k < size; ++k) {
+        changed[k] = realRK() >= 0.7;
+        if (changed[k])
+            csr.random_keys[k] = randomKey();
+    }
+    Fingerprint f_full, f_delta;
+    decoder(csr, &f_full);
+    std::vector<usize> full = csr.labels;
+    deltaDecoder(csr, l.data(), changed, &f_delta);
+    IS_TRUE(full == csr.labels);
+    IS_TRUE(f_full == f_delta);
+}
+
+void testDecoderPolicies() {
+    CSR csr("input/usps_norm_5NN.mtx", true);
+    const usize size = csr.m;
+    csr.random_keys.resize(size);
+    csr.indexed_rk.resize(size);
+    csr.tmp_rk.resize(size);
+    for (usize i = 0; i < size; ++i)
+        csr.random_keys[i] = randomKey();
+
+    // Level decoder: a permutation in reverse BFS order (every vertex but the roots has a neighbour
+    // labeled after it) from the largest key, stable under encode/decode
+    Fingerprint f;
+    levelDecoder(csr, &f);
+    const std::vector<usize> l = csr.labels;
+    IS_TRUE(isPermutation(l, size));
+    IS_TRUE(f == fingerprintLabels(l));
+    IS_TRUE(l[std::max_element(csr.random_keys.begin(), csr.random_keys.end()) - csr.random_keys.begin()] == size - 1);
+    usize n_roots = 0;
+    for (usize v = 0; v < size; ++v) {
+        bool has_parent = false;
+        for (usize j = csr.row_index[v]; j < csr.row_index[v + 1]; ++j)
+            has_parent = has_parent || l[csr.col_index[j]] > l[v];
+        n_roots += !has_parent;
+    }
+    IS_TRUE(n_roots == 1);
+    LevelDecoder::encode(csr);
+    IS_TRUE(l == csr.labels);
+
+    // Sloan decoder: a permutation, keys unchanged, same labels for the same keys
+    const std::vector<rkT> keys = csr.random_keys;
+    SloanDecoder::decode(csr, &f);
+    IS_TRUE(isPermutation(csr.labels, size));
+    IS_TRUE(f == fingerprintLabels(csr.labels));
+    IS_TRUE(keys == csr.random_keys);
+    Fingerprint f_again;
+    SloanDecoder::decode(csr, &f_again);
+    IS_TRUE(f == f_again);
+
+    // Sort decoder: fingerprint of assignLabels
+    SortDecoder::decode(csr, &f);
+    IS_TRUE(f == fingerprintLabels(csr.labels));
+}
+
+// Random keys for csr and their decoding
+// The keys encode a random permutation, so they are distinct for every key type (float keys drawn
+// independently tie on a few thousand vertices)
+void randomLabels(CSR& csr) {
+    csr.labels.resize(csr.m);
+    std::iota(csr.labels.begin(), csr.labels.end(), 0);
+    std::shuffle(csr.labels.begin(), csr.labels.end(), getRNG());
+    csr.random_keys.resize(csr.m);
+    csr.indexed_rk.resize(csr.m);
+    csr.tmp_rk.resize(csr.m);
+    encoder(csr);
+    decoder(csr);
+}
+
+void testImproveProfile() {
+    CSR csr("input/usps_norm_5NN.mtx", true);
+    const usize size = csr.m;
+    randomLabels(csr);
+    csr.evaluateProfile();
+    const unsigned long initial = csr.profile;
+
+    // The maintained profile is exact and not worse (a short pass, usually stopped by the cap)
+    bool stopped = false;
+    const unsigned long reduction = csr.improveProfile(std::chrono::milliseconds(200), &stopped);
+    const unsigned long improved = csr.profile;
+    IS_TRUE(isPermutation(csr.labels, size));
+    IS_TRUE(reduction > 0 && improved == initial - reduction);
+    csr.evaluateProfile();
+    IS_TRUE(csr.profile == improved);
+
+    // The inverse (vertex of each label) was kept up to date
+    bool inverse_ok = true;
+    for (usize v = 0; v < size; ++v)
+        inverse_ok = inverse_ok && csr.inverse[csr.labels[v]] == v;
+    IS_TRUE(inverse_ok);
+
+    // Lamarckian: the improved labels are the decoding of the rewritten keys
+    const std::vector<usize> l = csr.labels;
+    IS_TRUE(encoderSorted(csr));
+    decoder(csr);
+    IS_TRUE(l == csr.labels);
+
+    // A pass stopped by the cap reports it (the first check is after 256 swaps, far from a local optimum)
+    randomLabels(csr);
+    csr.improveProfile(std::chrono::nanoseconds(0), &stopped);
+    IS_TRUE(stopped);
+
+    // Local optimum: once a pass ends on its own, a second one does not change it
+    CSR small("input/mst.mtx", true);
+    randomLabels(small);
+    small.improveProfile(std::chrono::seconds(10), &stopped);
+    IS_TRUE(!stopped);
+    const std::vector<usize> optimum = small.labels;
+    IS_TRUE(small.improveProfile(std::chrono::seconds(10), &stopped) == 0);
+    IS_TRUE(!stopped && optimum == small.labels);
+}
+
+// Encode a random permutation with keys of type Key and decode it back
+// True if the keys are strictly increasing along the permutation and the decoding restores it
+template <typename Key>
+bool keysRoundTrip(const usize size) {
+    std::vector<usize> l(size);
+    std::iota(l.begin(), l.end(), 0);
+    std::shuffle(l.begin(), l.end(), getRNG());
+    std::vector<Key> keys(size), tmp(size);
+    sortedKeys(size, tmp, [&](const usize i, const Key key) {
+        keys[l[i]] = key;
+    });
+
+    bool ok = true;
+    for (usize i = 1; i < size; ++i)
+        ok = ok && keys[l[i]] > keys[l[i - 1]];
+    std::vector<IndexedKey<Key>> sorted(size), scratch;
+    for (usize i = 0; i < size; ++i)
+        sorted[i] = {keys[i], i};
+    sortByKey(sorted, scratch);
+    for (usize i = 0; i < size; ++i)
+        ok = ok && sorted[i].index == l[i];
+    return ok;
+}
+
+void testU32Keys() {
+    // Encode and decode with 32-bit rank-quantized keys (std::sort and radix sort sizes)
+    for (const usize size : {2u, 100u, 5000u, 100000u})
+        IS_TRUE(keysRoundTrip<uint32_t>(size));
+    IS_TRUE(keyReal(uint32_t(0)) == 0 && keyReal(uint32_t(1) << 31) == 0.5 && keyReal(~uint32_t(0)) < 1);
+
+    // Ties (keys inherited from different parents) are broken by the index
+    for (const usize size : {100u, 5000u}) {
+        std::vector<IndexedKey<uint32_t>> sorted(size), scratch;
+        for (usize i = 0; i < size; ++i)
+            sorted[i] = {static_cast<uint32_t>(usizeRandomNumber(0, 20)) << 27, i};
+        std::vector<IndexedKey<uint32_t>> reference = sorted;
+        std::sort(reference.begin(), reference.end(), [](const IndexedKey<uint32_t>& x, const IndexedKey<uint32_t>& y) {
+            return x.value < y.value || (x.value == y.value && x.index < y.index);
+        });
+        sortByKey(sorted, scratch);
+        bool same = true;
+        for (usize i = 0; i < size; ++i)
+            same = same && sorted[i].index == reference[i].index;
+        IS_TRUE(same);
+    }
+}
+
+void testInverseLabels() {
+    CSR csr("input/usps_norm_5NN.mtx", true);
+    const usize size = csr.m;
+    csr.random_keys.resize(size);
+    csr.indexed_rk.resize(size);
+    csr.tmp_rk.resize(size);
+    const auto isInverse = [&csr]() {
+        for (usize i = 0; i < csr.m; ++i) {
+            if (csr.inverse[csr.labels[i]] != i)
+                return false;
+        }
+        return true;
+    };
+
+    // Every decoder and encoder leaves the inverse of labels (the rank of each key for the sort decoder)
+    for (usize i = 0; i < size; ++i)
+        csr.random_keys[i] = randomKey();
+    Fingerprint f;
+    decoder(csr, &f);
+    IS_TRUE(isInverse());
+    decoderSort(csr);
+    IS_TRUE(isInverse());
+    levelDecoder(csr);
+    IS_TRUE(isInverse());
+    sloanDecoder(csr);
+    IS_TRUE(isInverse());
+    std::shuffle(csr.labels.begin(), csr.labels.end(), getRNG());
+    encoder(csr);
+    IS_TRUE(isInverse());
+}
+
+void testKeyTypes() {
+    for (const usize size : {1u, 100u, 5000u}) {
+        IS_TRUE(keysRoundTrip<double>(size));
+        IS_TRUE(keysRoundTrip<float>(size));
+        IS_TRUE(keysRoundTrip<uint32_t>(size));
+    }
+    // Rounding the sums to float puts neighbouring keys on the same value at this size
+    IS_TRUE(keysRoundTrip<float>(1 << 21));
+}
+
+void testEncoder() {
+    for (const usize size : {1u, 2u, 3u, 257u, 100000u}) {
+        CSR csr(size, 0);
+        csr.random_keys.resize(size);
+        csr.indexed_rk.resize(size);
+        csr.tmp_rk.resize(size);
+        std::vector<usize> l(size);
+        std::iota(l.begin(), l.end(), 0);
+        std::shuffle(l.begin(), l.end(), getRNG());
+
+        // Encode then decode (radix and reference decoders): the labels round-trip
+        csr.labels = l;
+        encoder(csr);
+        decoder(csr);
+        IS_TRUE(l == csr.labels);
+        decoderSort(csr);
+        IS_TRUE(l == csr.labels);
+
+        // The keys are uniforms in [0, 1] (sorted by label)
+        realT sum = 0;
+        bool in_range = true;
+        for (const auto key : csr.random_keys) {
+            in_range = in_range && keyReal(key) >= 0 && keyReal(key) <= 1;
+            sum += keyReal(key);
+        }
+        IS_TRUE(in_range);
+        if (size == 100000u)
+            IS_TRUE(std::abs(sum / size - 0.5) < 0.01);
+    }
+}
+
+void testRNGStreams() {
+    const usize saved_threads = num_threads;
+
+    // Tasks drawing from their own streams: same draws with 1 and 4 threads
+    const auto draws = [](const usize threads) {
+        num_threads = threads;
+        std::vector<uint64_t> first(64);
+        parallelTasks(first.size(), [&first](usize, const usize task) {
+            const ScopedRNG stream(streamRNG(42, task));
+            first[task] = getRNG()() ^ usizeRandomNumber(0, 1000);
+        });
+        return first;
+    };
+    const std::vector<uint64_t> serial = draws(1);
+    IS_TRUE(serial == draws(4));
+    // Different streams
+    IS_TRUE(std::set<uint64_t>(serial.begin(), serial.end()).size() == serial.size());
+
+    // The generator of the thread is restored
+    const Xoshiro256 before = getRNG();
+    {
+        const ScopedRNG stream(streamRNG(1, 2));
+        getRNG()();
+    }
+    Xoshiro256 copy = before;
+    IS_TRUE(copy() == getRNG()());
+
+    num_threads = saved_threads;
+}
+
+void testReportedProfile() {
+    // The profile reported by the BRKGA-Pr (best_profile) is the profile of the returned labels, for every
+    // decoder (labelings of the heuristics that the level and Sloan decoders cannot encode are not reported)
+    for (const Decoder decoder : {Decoder::Sort, Decoder::Level, Decoder::Sloan}) {
+        CSR csr("input/usps_norm_5NN.mtx", true);
+        csr.max_time = std::chrono::seconds(0);
+        BRKGAOptions opt;
+        opt.decoder = decoder;
+        brkga(csr, 10, 4, 2, 0.75, 1, opt);
+        const unsigned long reported = csr.best_profile;
+        IS_TRUE(isPermutation(csr.labels, csr.m));
+        csr.evaluateProfile();
+        IS_TRUE(reported == csr.profile);
+    }
+}
+
+void testPopulationArena() {
+    const usize size = 37;
+    CSR csr(size, 0);
+    csr.random_keys.resize(size);
+    csr.indexed_rk.resize(size);
+    csr.tmp_rk.resize(size);
+    csr.labels.resize(size);
+    PopulationArena arena(3, csr.m);
+
+    // Rows start on cache lines
+    bool aligned = true;
+    for (usize slot = 0; slot < arena.slots(); ++slot) {
+        aligned = aligned && reinterpret_cast<uintptr_t>(arena.keys(slot)) % 64 == 0;
+        aligned = aligned && reinterpret_cast<uintptr_t>(arena.labels(slot)) % 64 == 0;
+    }
+    IS_TRUE(aligned);
+
+    // Store and load round trip, other slots untouched
+    for (usize slot = 0; slot < arena.slots(); ++slot) {
+        for (usize r = 0; r < csr.m; ++r)
+            csr.random_keys[r] = static_cast<rkT>(((r + slot) % csr.m + 1) / static_cast<realT>(csr.m + 1));
+        decoder(csr);
+        arena.store(slot, csr);
+    }
+    const std::vector<usize> labels2 = csr.labels;
+    arena.load(1, csr);
+    arena.load(2, csr);
+    IS_TRUE(csr.labels == labels2);
+    const SolutionRK solution = arena.solution(0, 7);
+    arena.store(1, solution);
+    arena.load(1, csr);
+    IS_TRUE(csr.labels == solution.labels && csr.random_keys == solution.random_keys);
+    // The inverse of the loaded labels is rebuilt in the workspace
+    bool inverse_ok = true;
+    for (usize r = 0; r < csr.m; ++r)
+        inverse_ok = inverse_ok && csr.inverse[csr.labels[r]] == r;
+    IS_TRUE(inverse_ok);
+    IS_TRUE(solution.profile == 7);
+
+    // Lean arena: keys only
+    PopulationArena lean(3, csr.m, false);
+    IS_TRUE(!lean.hasLabels() && lean.bytes() < arena.bytes());
+    lean.store(2, solution);
+    IS_TRUE(lean.solution(2, 7).labels.empty() && lean.solution(2, 7).random_keys == solution.random_keys);
+
+    // Ranking by value, ties by slot
+    std::vector<Ranked> population = {{5, 2}, {3, 1}, {5, 0}};
+    std::sort(population.begin(), population.end());
+    IS_TRUE(population[0].slot == 1 && population[1].slot == 0 && population[2].slot == 2);
+}
+
+void testRankedPool() {
+    // Slots 0 to 3 ranked, slot 4 free
+    RankedPool pool({{40, 0}, {10, 1}, {30, 2}, {20, 3}}, 2, 5);
+    IS_TRUE(pool.best() == 10 && pool.worstElite() == 20);
+
+    // Better than the worst: replaces it and the evicted slot is returned
+    IS_TRUE(pool.offer({15, 4}, false) == 0);
+    IS_TRUE(pool.worstElite() == 15);
+    // Not better: rejected unless forced
+    IS_TRUE(pool.offer({50, 0}, false) == 0);
+    IS_TRUE(pool.offer({50, 0}, true) == 2);
+    const std::vector<Ranked> ranking = pool.snapshot();
+    IS_TRUE(ranking.size() == 4 && std::is_sorted(ranking.begin(), ranking.end()) && ranking.back().slot == 0);
+    IS_TRUE(pool.accepted == 2 && pool.rejected == 1);
+
+    // Concurrent readers and writers: pinned slots are not written, the ranking keeps its slots
+    const usize saved_threads = num_threads;
+    num_threads = 4;
+    const usize P = 8, slots = P + 4;
+    std::vector<Ranked> initial(P);
+    for (usize i = 0; i < P; ++i)
+        initial[i] = {1000 + i, i};
+    RankedPool shared(initial, 2, slots);
+    std::vector<std::atomic<usize>> writing(slots);
+    std::atomic<bool> overlap{false};
+    parallelTasks(4, [&](usize, const usize task) {
+        usize own = P + task;
+        for (usize k = 0; k < 2000; ++k) {
+            const Ranked parent = shared.pin(k % P);
+            overlap = overlap || writing[parent.slot] != 0;
+            shared.release(parent.slot);
+            ++writing[own];
+            --writing[own];
+            own = shared.offer({999 - k, own}, k % 3 == 0);
+            shared.acquire(own);
+        }
+    });
+    IS_TRUE(!overlap);
+    std::set<usize> in_ranking;
+    for (const Ranked& individual : shared.snapshot())
+        in_ranking.insert(individual.slot);
+    IS_TRUE(in_ranking.size() == P);
+    num_threads = saved_threads;
+}
+
+void testMutantFactory() {
+    const usize size = 50;
+    CSR csr(size, 0);
+    csr.random_keys.resize(size);
+    csr.labels.resize(size);
+    csr.inverse.resize(size);
+    PopulationArena arena(1, size);
+    // Random keys, their value is the first draw
+    const auto build = [](CSR& ws) {
+        const unsigned long value = getRNG()() % 1000;
+        for (auto& key : ws.random_keys)
+            key = randomKey();
+        return value;
+    };
+
+    // Same sequence of mutants with 1 and 3 producers
+    const auto sequence = [&](const usize producers) {
+        MutantFactory factory(csr, producers, 2, 8, 42, build);
+        std::vector<std::pair<unsigned long, std::vector<rkT>>> popped;
+        for (usize k = 0; k < 20; ++k) {
+            const unsigned long value = factory.pop(arena, 0);
+            popped.push_back({value, std::vector<rkT>(arena.keys(0), arena.keys(0) + size)});
+        }
+        IS_TRUE(factory.built >= 20);
+        const usize depth = factory.currentDepth();
+        IS_TRUE(depth >= 2 && depth <= 8);
+        return popped;
+    };
+    const auto serial = sequence(1);
+    IS_TRUE(serial == sequence(3));
+    IS_TRUE(serial[0].second != serial[1].second);
+
+    // Concurrent pops (more consumers than buffers, as in the steady-state engine): every mutant is
+    // popped once and with its own keys, although the pops finish out of order
+    const usize saved_threads = num_threads;
+    num_threads = 6;
+    const usize pops = 300;
+    const auto identified = [](CSR& ws) {
+        const unsigned long value = getRNG()();
+        for (auto& key : ws.random_keys)
+            key = randomKey();
+        if (value % 4 == 0)
+            std::this_thread::sleep_for(std::chrono::microseconds(200));
+        return value;
+    };
+    std::vector<std::pair<unsigned long, std::vector<rkT>>> expected;
+    {
+        MutantFactory factory(csr, 1, 2, 4, 7, identified);
+        for (usize k = 0; k < pops; ++k) {
+            const unsigned long value = factory.pop(arena, 0);
+            expected.push_back({value, std::vector<rkT>(arena.keys(0), arena.keys(0) + size)});
+        }
+    }
+    MutantFactory factory(csr, 3, 2, 4, 7, identified);
+    PopulationArena concurrent(pops, size);
+    std::vector<unsigned long> values(pops);
+    parallelTasks(pops, [&](usize, const usize task) {
+        values[task] = factory.pop(concurrent, task);
+    });
+    std::vector<std::pair<unsigned long, std::vector<rkT>>> popped;
+    for (usize task = 0; task < pops; ++task)
+        popped.push_back({values[task], std::vector<rkT>(concurrent.keys(task), concurrent.keys(task) + size)});
+    std::sort(expected.begin(), expected.end());
+    std::sort(popped.begin(), popped.end());
+    IS_TRUE(popped == expected);
+    num_threads = saved_threads;
+}
+
+void testMailbox() {
+    Mailbox<std::vector<usize>> box;
+    IS_TRUE(box.take() == nullptr);
+
+    // The latest message is kept, the previous one is discarded
+    box.post(std::make_unique<std::vector<usize>>(std::vector<usize>{1, 2}));
+    box.post(std::make_unique<std::vector<usize>>(std::vector<usize>{3}));
+    const auto message = box.take();
+    IS_TRUE(message != nullptr && *message == std::vector<usize>{3});
+    IS_TRUE(box.discarded == 1);
+    IS_TRUE(box.take() == nullptr);
+
+    // Concurrent senders and receiver: every message is either taken or discarded
+    const usize saved_threads = num_threads;
+    num_threads = 4;
+    Mailbox<usize> shared;
+    std::atomic<usize> posted{0}, taken{0};
+    parallelTasks(4000, [&](const usize worker, const usize task) {
+        if (worker == 0 && shared.take()) {
+            ++taken;
+        } else if (worker != 0) {
+            shared.post(std::make_unique<usize>(task));
+            ++posted;
+        }
+    });
+    if (shared.take())
+        ++taken;
+    IS_TRUE(taken + shared.discarded == posted);
+    num_threads = saved_threads;
+}
+
+void testSharedBoard() {
+    const usize size = 100;
+    SharedBoard board(3, size, 2);
+    std::vector<SolutionRK> sent(3), received;
+    for (usize j = 0; j < sent.size(); ++j) {
+        sent[j].profile = 10 + j;
+        sent[j].random_keys.resize(size);
+        for (auto& key : sent[j].random_keys)
+            key = randomKey();
+    }
+
+    // Nothing published, then the migrants (at most the capacity, keys and values only) are read once
+    uint64_t seen = 0;
+    IS_TRUE(!board.read(1, seen, received));
+    board.publish(1, sent);
+    IS_TRUE(board.read(1, seen, received));
+    IS_TRUE(received.size() == 2 && received[1].profile == 11 && received[1].random_keys == sent[1].random_keys && received[1].labels.empty());
+    IS_TRUE(!board.read(1, seen, received));
+
+    // Shared with a child process: its result and its stop are seen by the parent
+    const pid_t child = fork();
+    if (child == 0) {
+        board.setResult(2, 7, std::vector<usize>(size, 5));
+        board.stop();
+        _exit(EXIT_SUCCESS);
+    }
+    waitpid(child, nullptr, 0);
+    unsigned long value = 0;
+    std::vector<usize> labels;
+    IS_TRUE(board.result(2, value, labels) && value == 7 && labels == std::vector<usize>(size, 5));
+    IS_TRUE(!board.result(0, value, labels));
+    IS_TRUE(board.stopped());
+}
+
+void testParallelTasks() {
+    const usize saved_threads = num_threads;
+    num_threads = 4;
+
+    // Every task runs once, on a worker in [0, numWorkers)
+    const usize tasks = 1000;
+    std::vector<usize> runs(tasks, 0), worker_of(tasks);
+    parallelTasks(tasks, [&](const usize worker, const usize task) {
+        ++runs[task];
+        worker_of[task] = worker;
+    });
+    IS_TRUE(std::all_of(runs.begin(), runs.end(), [](const usize r) { return r == 1; }));
+    IS_TRUE(*std::max_element(worker_of.begin(), worker_of.end()) < numWorkers(tasks));
+    IS_TRUE(numWorkers(2) == 2);
+
+    // Loops inside a task run serially
+    std::vector<usize> inner(8, 0);
+    parallelTasks(8, [&](usize, const usize task) {
+        inner[task] = numChunks(1 << 20, 1) + numWorkers(8);
+    });
+    IS_TRUE(std::all_of(inner.begin(), inner.end(), [](const usize c) { return c == 2; }));
+    IS_TRUE(!in_parallel);
+
+    // A long task: the workers steal the ranges of the others (the pool threads may start before the caller,
+    // so the long task is on any of them)
+    std::vector<TaskStats> stats(numWorkers(tasks));
+    std::vector<std::atomic<usize>> count(tasks);
+    usize long_worker = 0;
+    parallelTasks(tasks, [&](const usize worker, const usize task) {
+        if (task == 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            long_worker = worker;
+        }
+        ++count[task];
+    }, &stats);
+    IS_TRUE(std::all_of(count.begin(), count.end(), [](const std::atomic<usize>& c) { return c == 1; }));
+    unsigned long total = 0, steals = 0;
+    for (const TaskStats& st : stats) {
+        total += st.tasks;
+        steals += st.steals;
+    }
+    IS_TRUE(total == tasks && steals > 0);
+    IS_TRUE(stats[long_worker].busy >= std::chrono::milliseconds(50));
+
+    // The threads of the pool persist between calls: chunk c runs on the same thread every time
+    static thread_local usize loops = 0;
+    std::vector<usize> calls(4);
+    for (usize call = 0; call < 3; ++call)
+        parallelFor(4, 1, [&calls](const usize c, usize, usize) { calls[c] = ++loops; });
+    IS_TRUE(calls[1] >= 3 && calls[3] >= 3);
+
+    // A share of the threads for the loops of a scope (at least 1 and at most num_threads), ignored inside a loop
+    {
+        const ScopedThreads share(3);
+        IS_TRUE(numWorkers(tasks) == 3);
+        {
+            const ScopedThreads none(0);
+            IS_TRUE(numWorkers(tasks) == 1);
+        }
+        parallelTasks(3, [](usize, usize) { const ScopedThreads nested(1); });
+        IS_TRUE(num_threads == 3);
+    }
+    IS_TRUE(num_threads == 4);
+    {
+        const ScopedThreads more(8);
+        IS_TRUE(num_threads == 4);
+    }
+
+    num_threads = saved_threads;
+}
+
+void testCrossover() {
+    // Masks: frequency of the inherited genes within 5 standard deviations of PROB, exact for PROB 0 and 1
+    Xoshiro256 rng(11);
+    for (const realT prob : {0.001, 0.3, 0.5, 0.7, static_cast<realT>(0.7f), 0.75, 0.999}) {
+        const BernoulliMask inherit(prob);
+        usize ones = 0;
+        const usize words = 20000;
+        for (usize w = 0; w < words; ++w)
+            ones += std::popcount(inherit(rng));
+        const realT draws = 64.0 * words;
+        IS_TRUE(std::abs(static_cast<realT>(ones) / draws - prob) < 5 * std::sqrt(prob * (1 - prob) / draws));
+    }
+    IS_TRUE(BernoulliMask(0)(rng) == 0);
+    IS_TRUE(BernoulliMask(1)(rng) == ~uint64_t(0));
+
+    // Child keys from one of the parents, changed when taken from parent2 and different
+    const usize size = 1000;
+    std::vector<rkT> p1(size), p2(size), child(size);
+    std::vector<char> changed(size);
+    for (usize k = 0; k < size; ++k) {
+        p1[k] = randomKey();
+        p2[k] = k % 3 == 0 ? p1[k] : randomKey();
+    }
+    const BernoulliMask inherit(0.7);
+    Xoshiro256 rng1(5);
+    biasedCrossover(p1, p2, child, changed, inherit, rng1);
+    bool valid = true;
+    for (usize k = 0; k < size; ++k)
+        valid = valid && (child[k] == p1[k] || child[k] == p2[k]) && changed[k] == (child[k] != p1[k]);
+    IS_TRUE(valid);
+
+    // Same child for the same seed
+    const std::vector<rkT> first = child;
+    Xoshiro256 rng2(5);
+    biasedCrossover(p1, p2, child, changed, inherit, rng2);
+    IS_TRUE(first == child);
+}
+
+void testParallelRK() {
+    const usize size = PARALLEL_RK_MIN + 12345;
+    const usize saved_threads = num_threads;
+    CSR csr(size, 0);
+    csr.random_keys.resize(size);
+    csr.labels.resize(size);
+    csr.indexed_rk.resize(size);
+    csr.tmp_rk.resize(size);
+    std::vector<usize> l(size);
+    std::iota(l.begin(), l.end(), 0);
+    std::shuffle(l.begin(), l.end(), getRNG());
+
+    // Encoder: same keys for a fixed seed with 1 and 4 threads
+    csr.labels = l;
+    num_threads = 1;
+    getRNG().seed(7);
+    encoder(csr);
+    const std::vector<rkT> serial_keys = csr.random_keys;
+    num_threads = 4;
+    getRNG().seed(7);
+    encoder(csr);
+    IS_TRUE(serial_keys == csr.random_keys);
+
+    // Decoder: parallel radix sort gives the labels of the serial one (and the round trip)
+    decoder(csr);
+    IS_TRUE(l == csr.labels);
+    for (usize i = 0; i < size; ++i)
+        csr.random_keys[i] = usizeRandomNumber(0, 1000) / 1000.0;
+    decoder(csr);
+    l = csr.labels;
+    num_threads = 1;
+    decoder(csr);
+    IS_TRUE(l == csr.labels);
+
+    num_threads = saved_threads;
+}
+
+void testFingerprintCache() {
+    CSR csr(5, 10);
+    csr.random_keys = keysOf({0.3, 0.1, 0.5, 0.2, 0.4});
+    csr.labels.resize(5);
+    csr.indexed_rk.resize(5);
+    Fingerprint f1, f2, f3;
+
+    // Same labels, same fingerprint (and the labels are not changed by hashing)
+    decoder(csr, &f1);
+    const std::vector<usize> l = csr.labels;
+    decoder(csr);
+    IS_TRUE(l == csr.labels);
+    csr.random_keys = keysOf({0.6, 0.2, 0.9, 0.3, 0.7});
+    decoder(csr, &f2);
+    IS_TRUE(l == csr.labels);
+    IS_TRUE(f1 == f2);
+
+    // Different labels
+    csr.random_keys = keysOf({0.1, 0.3, 0.5, 0.2, 0.4});
+    decoder(csr, &f3);
+    IS_TRUE(!(f1 == f3));
+
+    FitnessCache cache(4);
+    unsigned long value = 0;
+    IS_TRUE(!cache.find(f1, value));
+    cache.insert(f1, 42);
+    IS_TRUE(cache.find(f2, value));
+    IS_TRUE(value == 42);
+    IS_TRUE(!cache.find(f3, value));
+    IS_TRUE(cache.hits == 1);
+    IS_TRUE(cache.misses == 2);
+
+    // Bounded: a full table drops the insertion
+    FitnessCache tiny(1);
+    Fingerprint f = f1;
+    for (usize i = 0; i < 3; ++i) {
+        f.add(i);
+        tiny.insert(f, i);
+    }
+    IS_TRUE(tiny.dropped == 1);
+}
+
 void testEccentricityNWidth() {
     CSR csr("input/test1.mtx");
 
@@ -337,16 +1234,40 @@ void testEccentricityNWidth() {
 int main() {
     std::cout << "\n Executing unit tests...";
 
-    // "realT" must be double (in types.hpp) for the BRKGA's encoder to work
+    // The tests run with the key type of the build (rkT: double by default, make KEYS=u32 or KEYS=float)
     testEncoderDecoder();
+    testFingerprintCache();
+    testRadixDecoder();
+    testEncoder();
+    testKeyTypes();
+    testU32Keys();
+    testInverseLabels();
+    testDeltaDecoder();
+    testDecoderPolicies();
+    testImproveProfile();
+    testParallelRK();
+    testCrossover();
+    testParallelTasks();
+    testRNGStreams();
+    testPopulationArena();
+    testReportedProfile();
+    testRankedPool();
+    testMutantFactory();
+    testMailbox();
+    testSharedBoard();
     testCSRFromFile2();
     testCSRFromFile3();
+    testSharedGraph();
     testLastLevel(); 
     testDiameter();
     testEccentricityNWidth();
     testProfile2();
     testProfile3();
+    testOrderingMetrics();
+    testFeasibility();
+    testLowerBounds();
 
     if (!failed)
         std::cout << "\n All " << n <<" tests passed." << std::endl;
+    return failed ? EXIT_FAILURE : EXIT_SUCCESS;
 }
\ No newline at end of file